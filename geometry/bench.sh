@@ -0,0 +1,9 @@
+#!/bin/bash
+
+set -e
+
+g++ -std=c++17 -O3 -march=native -fno-math-errno -I./src bench/bench.cpp -o geometry_bench -lbenchmark -lpthread
+if [ -n "$BENCH_JSON" ]; then  # machine-readable results for regression tracking, console output unchanged
+    set -- --benchmark_out="$BENCH_JSON" --benchmark_out_format=json "$@"
+fi
+./geometry_bench "$@"
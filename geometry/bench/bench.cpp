@@ -0,0 +1,1184 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <new>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "geometry.h"
+#include "spatial_index.h"
+#include "polygon_soa.h"
+#include "shape_store.h"
+#include "congruence.h"
+#include "convex_hull.h"
+#include "simplification.h"
+#include "intersection.h"
+#include "triangulation.h"
+#include "sincos.h"
+#include "point_index.h"
+#include "shape_io.h"
+#include "scene.h"
+#include "compact.h"
+#include "polygon_arena.h"
+
+
+// Heap allocations of the calling thread while counting_allocations is set, for BM_PolygonArena. Other
+// benchmarks only pay a thread-local test per allocation.
+static thread_local bool counting_allocations = false;
+static thread_local size_t allocations = 0;
+
+// noinline: inlined into callers, malloc and free show up paired with new and delete in -Wmismatched-new-delete
+__attribute__((noinline)) void* operator new(size_t size) {
+    if (counting_allocations) {
+        ++allocations;
+    }
+    if (void* res = std::malloc(size > 0 ? size : 1)) {
+        return res;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+__attribute__((noinline)) void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete[](void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+
+class CacheMissCounter {  // last-level cache misses of this thread; available() is false without a usable PMU
+public:
+    CacheMissCounter() {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        this->fd = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    ~CacheMissCounter() {
+        if (this->fd >= 0) {
+            close(this->fd);
+        }
+    }
+
+    bool available() const {
+        return this->fd >= 0;
+    }
+
+    long long read() const {
+        long long res = 0;
+        if ((this->fd < 0) or (::read(this->fd, &res, sizeof(res)) != sizeof(res))) {
+            return 0;
+        }
+        return res;
+    }
+
+private:
+    int fd;
+};
+
+
+struct Scene {  // owns random triangles and circles spread over a square
+    explicit Scene(size_t count, double side = 1000) {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<double> coord(0, side), size(0.5, 5);
+        for (size_t i = 0; i < count; ++i) {
+            Point p(coord(gen), coord(gen));
+            if (i % 2 == 0) {
+                owned.emplace_back(new Polygon({p, Point(p.x + size(gen), p.y), Point(p.x, p.y + size(gen))}));
+            } else {
+                owned.emplace_back(new Circle(p, size(gen)));
+            }
+            shapes.push_back(owned.back().get());
+        }
+    }
+
+    std::vector<std::unique_ptr<Shape>> owned;
+    std::vector<Shape*> shapes;
+};
+
+std::vector<BoundingBox> RandomBoxes(size_t count, double side = 1000, double extent = 20) {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> coord(0, side);
+    std::vector<BoundingBox> boxes;
+    for (size_t i = 0; i < count; ++i) {
+        Point p(coord(gen), coord(gen));
+        boxes.emplace_back(p, Point(p.x + extent, p.y + extent));
+    }
+    return boxes;
+}
+
+
+static void BM_IndexBulkLoad(benchmark::State& state) {
+    Scene scene(state.range(0));
+    for (auto _ : state) {
+        ShapeIndex index(scene.shapes);
+        benchmark::DoNotOptimize(index.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IndexBulkLoad)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+static void BM_IndexInsert(benchmark::State& state) {
+    Scene scene(state.range(0));
+    for (auto _ : state) {
+        ShapeIndex index;
+        for (auto shape : scene.shapes) {
+            index.insert(shape);
+        }
+        benchmark::DoNotOptimize(index.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IndexInsert)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+static void BM_BoxQueryBruteForce(benchmark::State& state) {
+    Scene scene(state.range(0));
+    auto boxes = RandomBoxes(256);
+    size_t i = 0;
+    for (auto _ : state) {
+        const BoundingBox& box = boxes[i++ % boxes.size()];
+        std::vector<Shape*> res;
+        for (auto shape : scene.shapes) {
+            if (shape->boundingBox().intersects(box)) {
+                res.push_back(shape);
+            }
+        }
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(BM_BoxQueryBruteForce)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+static void BM_BoxQueryIndex(benchmark::State& state) {
+    Scene scene(state.range(0));
+    ShapeIndex index(scene.shapes);
+    auto boxes = RandomBoxes(256);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.queryBox(boxes[i++ % boxes.size()]).data());
+    }
+}
+BENCHMARK(BM_BoxQueryIndex)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+static void BM_PointQueryIndex(benchmark::State& state) {
+    Scene scene(state.range(0));
+    ShapeIndex index(scene.shapes);
+    auto boxes = RandomBoxes(256);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.queryPoint(boxes[i++ % boxes.size()].min).data());
+    }
+}
+BENCHMARK(BM_PointQueryIndex)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+static void BM_NearestIndex(benchmark::State& state) {
+    Scene scene(state.range(0));
+    ShapeIndex index(scene.shapes);
+    auto boxes = RandomBoxes(256);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.nearest(boxes[i++ % boxes.size()].min, 8).data());
+    }
+}
+BENCHMARK(BM_NearestIndex)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+
+Polygon RegularPolygon(size_t count, double radius = 10) {
+    std::vector<Point> vertices;
+    for (size_t i = 0; i < count; ++i) {
+        double angle = 2 * M_PI * i / count;
+        vertices.emplace_back(radius * cos(angle), radius * sin(angle));
+    }
+    return Polygon(vertices);
+}
+
+std::vector<Point> RandomPoints(size_t count, double side = 12) {
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> coord(-side, side);
+    std::vector<Point> points;
+    for (size_t i = 0; i < count; ++i) {
+        points.emplace_back(coord(gen), coord(gen));
+    }
+    return points;
+}
+
+static void BM_PolygonContainsPoint(benchmark::State& state) {
+    Polygon polygon = RegularPolygon(state.range(0));
+    auto points = RandomPoints(1024);
+    for (auto _ : state) {
+        size_t inside = 0;
+        for (const auto& p : points) {
+            inside += polygon.containsPoint(p);
+        }
+        benchmark::DoNotOptimize(inside);
+    }
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_PolygonContainsPoint)->RangeMultiplier(10)->Range(4, 100000);
+
+static void BM_PolygonContainsPoints(benchmark::State& state) {
+    Polygon polygon = RegularPolygon(state.range(0));
+    auto points = RandomPoints(1024);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(polygon.containsPoints(points).data());
+    }
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_PolygonContainsPoints)->RangeMultiplier(10)->Range(4, 100000);
+
+static void BM_ShapeContainsPoints(benchmark::State& state) {  // closed forms: 0 triangle, 1 rectangle, 2 ellipse, 3 circle
+    Point a(-3, -2), b(4, 1), c(0, 6);
+    Triangle triangle(a, b, c);
+    Rectangle rectangle(Point(-5, -4), Point(6, 3), 0.5);
+    Ellipse ellipse(Point(-2, 0), Point(3, 1), 9);
+    Circle circle(Point(1, 1), 5);
+    const Shape* shapes[] = {&triangle, &rectangle, &ellipse, &circle};
+    const Shape* shape = shapes[state.range(0)];
+    auto points = RandomPoints(4096);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(shape->containsPoints(points).data());
+    }
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_ShapeContainsPoints)->DenseRange(0, 3);
+
+
+static void BM_PolygonArea(benchmark::State& state) {
+    Polygon polygon = RegularPolygon(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(polygon.area());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PolygonArea)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+static void BM_PolygonSoAArea(benchmark::State& state) {
+    PolygonSoA polygon(RegularPolygon(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(polygon.area());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PolygonSoAArea)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+static void BM_PolygonPerimeter(benchmark::State& state) {
+    Polygon polygon = RegularPolygon(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(polygon.perimeter());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PolygonPerimeter)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+static void BM_PolygonSoAPerimeter(benchmark::State& state) {
+    PolygonSoA polygon(RegularPolygon(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(polygon.perimeter());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PolygonSoAPerimeter)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+
+static void BM_SceneTransformSequential(benchmark::State& state) {
+    Scene scene(state.range(0));
+    Line axis(Point(0, 1), Point(1, 3));
+    for (auto _ : state) {
+        for (auto shape : scene.shapes) {
+            shape->rotate(Point(500, 500), 1);
+            shape->scale(Point(500, 500), 1.0001);
+            shape->reflex(axis);
+            shape->reflex(Point(500, 500));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SceneTransformSequential)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+static void BM_SceneTransformCombined(benchmark::State& state) {
+    Scene scene(state.range(0));
+    Line axis(Point(0, 1), Point(1, 3));
+    for (auto _ : state) {
+        AffineTransform t = AffineTransform().rotate(Point(500, 500), 1).scale(Point(500, 500), 1.0001)
+                                             .reflex(axis).reflex(Point(500, 500));
+        transformShapes(scene.shapes, t);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SceneTransformCombined)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+static void BM_PolygonRotate(benchmark::State& state) {
+    Polygon polygon = RegularPolygon(state.range(0));
+    for (auto _ : state) {
+        polygon.rotate(Point(1, 1), 1);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PolygonRotate)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+
+struct MixedScene {  // the same shapes as a ShapeStore and as separately allocated Shape* (shuffled)
+    explicit MixedScene(size_t count) {
+        std::mt19937 gen(5);
+        std::uniform_real_distribution<double> coord(0, 1000), size(0.5, 5);
+        for (size_t i = 0; i < count; ++i) {
+            Point p(coord(gen), coord(gen));
+            Point q(p.x + size(gen), p.y + size(gen));
+            Point r(p.x, p.y + size(gen));
+            switch (i % 6) {
+                case 0: add(Polygon({p, q, r, Point(p.x - 1, p.y + 1)})); break;
+                case 1: add(Ellipse(p, q, 3 * calcDistance(p, q))); break;
+                case 2: add(Circle(p, size(gen))); break;
+                case 3: add(Rectangle(p, q, 2)); break;
+                case 4: add(Square(p, q)); break;
+                default: add(Triangle(p, q, r)); break;
+            }
+        }
+        std::shuffle(shapes.begin(), shapes.end(), gen);
+    }
+
+    template <class T>
+    void add(T shape) {
+        store.add(shape);
+        owned.emplace_back(new T(shape));
+        shapes.push_back(owned.back().get());
+    }
+
+    ShapeStore store;
+    std::vector<std::unique_ptr<Shape>> owned;
+    std::vector<Shape*> shapes;
+};
+
+static void BM_SceneAreaVirtual(benchmark::State& state) {
+    MixedScene scene(state.range(0));
+    for (auto _ : state) {
+        double res = 0;
+        for (auto shape : scene.shapes) {
+            res += shape->area();
+        }
+        benchmark::DoNotOptimize(res);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SceneAreaVirtual)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+static void BM_SceneAreaStore(benchmark::State& state) {
+    MixedScene scene(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(scene.store.totalArea());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SceneAreaStore)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+static void BM_ScenePerimeterVirtual(benchmark::State& state) {
+    MixedScene scene(state.range(0));
+    for (auto _ : state) {
+        double res = 0;
+        for (auto shape : scene.shapes) {
+            res += shape->perimeter();
+        }
+        benchmark::DoNotOptimize(res);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ScenePerimeterVirtual)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+static void BM_ScenePerimeterStore(benchmark::State& state) {
+    MixedScene scene(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(scene.store.totalPerimeter());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ScenePerimeterStore)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+
+static void BM_PolygonEquality(benchmark::State& state) {  // matching vertex sets, different start and direction
+    Polygon polygon = RegularPolygon(state.range(0));
+    std::vector<Point> vertices = polygon.getVertices();
+    std::rotate(vertices.begin(), vertices.begin() + vertices.size() / 3, vertices.end());
+    std::reverse(vertices.begin(), vertices.end());
+    Polygon relabeled(vertices);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(polygon == relabeled);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PolygonEquality)->RangeMultiplier(10)->Range(10, 100000);
+
+static void BM_PolygonCongruence(benchmark::State& state) {
+    Polygon polygon = RegularPolygon(state.range(0));
+    Polygon moved = polygon;
+    moved.rotate(Point(3, 4), 37);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(isCongruent(polygon, moved));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PolygonCongruence)->RangeMultiplier(10)->Range(10, 100000);
+
+static void BM_ConvexHull(benchmark::State& state) {
+    auto points = RandomPoints(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(convexHull(points).verticesCount());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConvexHull)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+
+static void BM_StreamingConvexHull(benchmark::State& state) {
+    auto points = RandomPoints(1 << 20);
+    for (auto _ : state) {
+        StreamingConvexHull streaming(state.range(0));
+        streaming.add(points);
+        benchmark::DoNotOptimize(streaming.hull().verticesCount());
+    }
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_StreamingConvexHull)->RangeMultiplier(16)->Range(1 << 12, 1 << 20);
+
+Polygon NoisyCircle(size_t count, double radius = 100) {
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<double> noise(-0.05, 0.05);
+    std::vector<Point> vertices;
+    for (size_t i = 0; i < count; ++i) {
+        double angle = 2 * M_PI * i / count;
+        double r = radius + noise(gen);
+        vertices.emplace_back(r * cos(angle), r * sin(angle));
+    }
+    return Polygon(vertices);
+}
+
+static void BM_SimplifyDouglasPeucker(benchmark::State& state) {
+    Polygon polygon = NoisyCircle(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(simplifyDouglasPeucker(polygon, 0.5).verticesCount());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SimplifyDouglasPeucker)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+static void BM_SimplifyVisvalingam(benchmark::State& state) {
+    Polygon polygon = NoisyCircle(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(simplifyVisvalingam(polygon, 0.5).verticesCount());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SimplifyVisvalingam)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+static void BM_AreaAfterSimplify(benchmark::State& state) {  // 0 raw contour, 1 simplified once up front
+    Polygon polygon = NoisyCircle(1 << 18);
+    Polygon simplified = simplifyDouglasPeucker(polygon, 0.5);
+    const Polygon& shape = state.range(0) ? simplified : polygon;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(shape.area());
+    }
+    state.counters["vertices"] = shape.verticesCount();
+}
+BENCHMARK(BM_AreaAfterSimplify)->DenseRange(0, 1);
+
+std::vector<Segment> RandomSegments(size_t count, double side = 1000, double length = 10) {
+    std::mt19937 gen(13);
+    std::uniform_real_distribution<double> coord(0, side), offset(-length, length);
+    std::vector<Segment> segments;
+    for (size_t i = 0; i < count; ++i) {
+        Point p(coord(gen), coord(gen));
+        segments.emplace_back(p, Point(p.x + offset(gen), p.y + offset(gen)));
+    }
+    return segments;
+}
+
+static void BM_IntersectingPairsBruteForce(benchmark::State& state) {
+    auto segments = RandomSegments(state.range(0));
+    for (auto _ : state) {
+        size_t count = 0;
+        for (size_t i = 0; i < segments.size(); ++i) {
+            for (size_t j = i + 1; j < segments.size(); ++j) {
+                count += segments[i].intersects(segments[j]);
+            }
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IntersectingPairsBruteForce)->RangeMultiplier(8)->Range(1 << 9, 1 << 15);
+
+static void BM_IntersectingPairsSweep(benchmark::State& state) {
+    auto segments = RandomSegments(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(intersectingPairs(segments).size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IntersectingPairsSweep)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+
+static void BM_PolygonsIntersect(benchmark::State& state) {  // crossing boundaries, no vertex inside the other one
+    Polygon lhs = RegularPolygon(state.range(0));
+    Polygon rhs = lhs;
+    rhs.reflex(Point(0, 7.5));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(polygonsIntersect(lhs, rhs));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PolygonsIntersect)->RangeMultiplier(8)->Range(8, 1 << 15);
+
+static void BM_ClipPolygon(benchmark::State& state) {
+    Polygon subject = RegularPolygon(state.range(0));
+    Polygon window({Point(-5, -5), Point(20, -5), Point(20, 20), Point(-5, 20)});
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(clipPolygon(subject, window).verticesCount());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ClipPolygon)->RangeMultiplier(16)->Range(16, 1 << 16);
+
+Polygon StarPolygon(size_t count) {  // non-convex: alternating outer and inner radius
+    std::vector<Point> vertices;
+    for (size_t i = 0; i < count; ++i) {
+        double radius = (i % 2) ? 6 : 10;
+        vertices.emplace_back(radius * cos(2 * M_PI * i / count), radius * sin(2 * M_PI * i / count));
+    }
+    return Polygon(vertices);
+}
+
+static void BM_EarClipping(benchmark::State& state) {
+    Polygon polygon = StarPolygon(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(earClippingIndices(polygon).data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EarClipping)->RangeMultiplier(4)->Range(8, 1 << 12);
+
+static void BM_MonotoneTriangulation(benchmark::State& state) {
+    Polygon polygon = StarPolygon(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(monotoneIndices(polygon).data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MonotoneTriangulation)->RangeMultiplier(4)->Range(8, 1 << 18);
+
+static void BM_TriangleMeshContainsPoint(benchmark::State& state) {
+    TriangleMesh mesh(StarPolygon(state.range(0)));
+    auto points = RandomPoints(1024);
+    for (auto _ : state) {
+        size_t count = 0;
+        for (const auto& p : points) {
+            count += mesh.containsPoint(p);
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_TriangleMeshContainsPoint)->RangeMultiplier(8)->Range(8, 1 << 12);
+
+static void BM_BatchSinCos(benchmark::State& state) {  // 0 std::sin + std::cos, 1 batchSinCos
+    std::mt19937 gen(17);
+    std::uniform_real_distribution<double> angle(-100, 100);
+    std::vector<double> angles(1 << 14), sines(angles.size()), cosines(angles.size());
+    for (auto& a : angles) {
+        a = angle(gen);
+    }
+    for (auto _ : state) {
+        if (state.range(0) == 0) {
+            for (size_t i = 0; i < angles.size(); ++i) {
+                sines[i] = sin(angles[i]);
+                cosines[i] = cos(angles[i]);
+            }
+        } else {
+            batchSinCos(angles.data(), angles.size(), sines.data(), cosines.data());
+        }
+        benchmark::DoNotOptimize(sines.data());
+        benchmark::DoNotOptimize(cosines.data());
+    }
+    state.SetItemsProcessed(state.iterations() * angles.size());
+}
+BENCHMARK(BM_BatchSinCos)->DenseRange(0, 1);
+
+struct Animation {  // hexagons spinning around their own centers, each with its own angular velocity
+    explicit Animation(size_t count) {
+        std::mt19937 gen(19);
+        std::uniform_real_distribution<double> coord(0, 1000), speed(-180, 180);
+        for (size_t i = 0; i < count; ++i) {
+            Point c(coord(gen), coord(gen));
+            std::vector<Point> vertices;
+            for (size_t k = 0; k < 6; ++k) {
+                vertices.emplace_back(c.x + cos(M_PI * k / 3), c.y + sin(M_PI * k / 3));
+            }
+            shapes.emplace_back(vertices);
+            centers.push_back(c);
+            speeds.push_back(speed(gen));
+        }
+    }
+
+    std::vector<Polygon> shapes;
+    std::vector<Point> centers;
+    std::vector<double> speeds;  // degrees per frame
+};
+
+// one frame: 0 per-vertex rotateX / rotateY with the angle, 1 rotate(center, degrees), 2 batched rotations
+static void BM_AnimationFrame(benchmark::State& state) {
+    Animation animation(state.range(1));
+    size_t n = animation.shapes.size();
+    for (auto _ : state) {
+        if (state.range(0) == 0) {
+            for (size_t i = 0; i < n; ++i) {
+                double rad = animation.speeds[i] * M_PI / 180;
+                const Point& c = animation.centers[i];
+                std::vector<Point> vertices = animation.shapes[i].getVertices();
+                for (auto& v : vertices) {
+                    double x = v.x - c.x, y = v.y - c.y;
+                    v = Point(rotateX(x, y, rad) + c.x, rotateY(x, y, rad) + c.y);
+                }
+                animation.shapes[i] = Polygon(vertices);
+            }
+        } else if (state.range(0) == 1) {
+            for (size_t i = 0; i < n; ++i) {
+                animation.shapes[i].rotate(animation.centers[i], animation.speeds[i]);
+            }
+        } else {
+            std::vector<Rotation> rotations = batchRotations(animation.speeds);
+            for (size_t i = 0; i < n; ++i) {
+                animation.shapes[i].rotate(animation.centers[i], rotations[i]);
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_AnimationFrame)->ArgsProduct({{0, 1, 2}, {1 << 10, 1 << 16}});
+
+std::vector<Point> PredicatePoints(bool degenerate, size_t count = 4096) {  // degenerate: all near the line y = x
+    std::mt19937 gen(23);
+    std::uniform_real_distribution<double> coord(-100, 100);
+    std::uniform_int_distribution<int> ulps(-4, 4);
+    std::vector<Point> points;
+    for (size_t i = 0; i < count; ++i) {
+        double x = coord(gen);
+        points.emplace_back(x, degenerate ? x + ulps(gen) * std::ldexp(std::abs(x), -52) : coord(gen));
+    }
+    return points;
+}
+
+// 0 plain cross product, 1 adaptive orientation on random points (filter), 2 adaptive on near-collinear points
+static void BM_Orientation(benchmark::State& state) {
+    auto points = PredicatePoints(state.range(0) == 2);
+    size_t n = points.size();
+    for (auto _ : state) {
+        double sum = 0;
+        for (size_t i = 0; i + 2 < n; ++i) {
+            double det = state.range(0) == 0 ? cross(points[i], points[i + 1], points[i + 2])
+                                             : orientation(points[i], points[i + 1], points[i + 2]);
+            sum += (det > 0) - (det < 0);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * (n - 2));
+}
+BENCHMARK(BM_Orientation)->DenseRange(0, 2);
+
+double PlainInCircle(const Point& a, const Point& b, const Point& c, const Point& d) {
+    double adx = a.x - d.x, ady = a.y - d.y, bdx = b.x - d.x, bdy = b.y - d.y, cdx = c.x - d.x, cdy = c.y - d.y;
+    return (adx * adx + ady * ady) * (bdx * cdy - cdx * bdy) + (bdx * bdx + bdy * bdy) * (cdx * ady - adx * cdy) +
+           (cdx * cdx + cdy * cdy) * (adx * bdy - bdx * ady);
+}
+
+// 0 plain determinant, 1 adaptive in-circle on random points, 2 adaptive on cocircular points
+static void BM_InCircle(benchmark::State& state) {
+    auto points = PredicatePoints(false);
+    if (state.range(0) == 2) {
+        for (size_t i = 0; i < points.size(); ++i) {  // on the unit circle up to rounding
+            points[i] = Point(cos(0.37 * i), sin(0.37 * i));
+        }
+    }
+    size_t n = points.size();
+    for (auto _ : state) {
+        double sum = 0;
+        for (size_t i = 0; i + 3 < n; ++i) {
+            double det = state.range(0) == 0 ? PlainInCircle(points[i], points[i + 1], points[i + 2], points[i + 3])
+                                             : inCircle(points[i], points[i + 1], points[i + 2], points[i + 3]);
+            sum += (det > 0) - (det < 0);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * (n - 3));
+}
+BENCHMARK(BM_InCircle)->DenseRange(0, 2);
+
+// 0 k-d tree, 1 grid hash; bulk build over n points
+static void BM_PointIndexBuild(benchmark::State& state) {
+    auto points = RandomPoints(state.range(1), 1000);
+    for (auto _ : state) {
+        if (state.range(0) == 0) {
+            PointKdTree tree(points);
+            benchmark::DoNotOptimize(tree.size());
+        } else {
+            PointGrid grid(points, 2000 / std::sqrt(double(points.size())));
+            benchmark::DoNotOptimize(grid.size());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_PointIndexBuild)->ArgsProduct({{0, 1}, {1 << 12, 1 << 20}});
+
+// 0 brute force, 1 k-d tree, 2 grid hash; 1024 batched nearest queries against n points
+static void BM_NearestNeighbor(benchmark::State& state) {
+    auto points = RandomPoints(state.range(1), 1000);
+    auto queries = RandomPoints(1024, 999);
+    PointKdTree tree(points);
+    PointGrid grid(points, 2000 / std::sqrt(double(points.size())));
+    for (auto _ : state) {
+        std::vector<size_t> res;
+        if (state.range(0) == 0) {
+            for (const auto& q : queries) {
+                size_t best = 0;
+                for (size_t i = 1; i < points.size(); ++i) {
+                    if (sqrDistance(q, points[i]) < sqrDistance(q, points[best])) {
+                        best = i;
+                    }
+                }
+                res.push_back(best);
+            }
+        } else {
+            res = state.range(0) == 1 ? tree.nearest(queries) : grid.nearest(queries);
+        }
+        benchmark::DoNotOptimize(res.data());
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+BENCHMARK(BM_NearestNeighbor)->ArgsProduct({{0, 1, 2}, {1 << 12}})->Args({1, 1 << 20})->Args({2, 1 << 20});
+
+static void BM_ClosestPair(benchmark::State& state) {
+    auto points = RandomPoints(state.range(0), 1000);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(closestPair(points));
+    }
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_ClosestPair)->Arg(1 << 12)->Arg(1 << 20);
+
+// Scene evaluation after one rotation per frame: 0 recomputes every ellipse parameter (each shape is measured as a
+// fresh Ellipse, as before the cache), 1 the cached parameters and the Circle fast path
+static void BM_EllipseSceneMeasure(benchmark::State& state) {
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<double> coord(0, 1000), size(0.5, 5);
+    std::vector<std::unique_ptr<Ellipse>> shapes;
+    for (size_t i = 0; i < size_t(state.range(1)); ++i) {
+        Point p(coord(gen), coord(gen));
+        if (i % 2 == 0) {
+            shapes.emplace_back(new Circle(p, size(gen)));
+        } else {
+            Point q(p.x + size(gen), p.y + size(gen));
+            shapes.emplace_back(new Ellipse(p, q, 3 * calcDistance(p, q)));
+        }
+    }
+    Rotation rotation = Rotation::degrees(0.5);
+    for (auto _ : state) {
+        double res = 0;
+        for (auto& shape : shapes) {
+            shape->rotate(Point(500, 500), rotation);
+        }
+        for (const auto& shape : shapes) {
+            for (int frame_reads = 0; frame_reads < 4; ++frame_reads) {  // layout, stats, export, ... per frame
+                Ellipse fresh(shape->focuses().first, shape->focuses().second, 2 * shape->radius());
+                Ellipse* measured = state.range(0) == 0 ? &fresh : shape.get();
+                benchmark::DoNotOptimize(measured);  // keeps the calls virtual and not folded across reads
+                res += measured->perimeter() + measured->area() + measured->eccentricity();
+            }
+        }
+        benchmark::DoNotOptimize(res);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_EllipseSceneMeasure)->ArgsProduct({{0, 1}, {1 << 10, 1 << 16}});
+
+// 0 the Triangle methods one by one, 1 Triangle::centers in one pass, 2 the batched TrianglesSoA kernel
+static void BM_TriangleCenters(benchmark::State& state) {
+    std::mt19937 gen(13);
+    std::uniform_real_distribution<double> coord(0, 1000);
+    std::vector<Triangle> triangles;
+    for (size_t i = 0; i < size_t(state.range(1)); ++i) {
+        triangles.emplace_back(Point(coord(gen), coord(gen)), Point(coord(gen), coord(gen)), Point(coord(gen), coord(gen)));
+    }
+    TrianglesSoA soa(triangles);
+    TriangleCentersSoA batch;
+    for (auto _ : state) {
+        double res = 0;
+        if (state.range(0) == 0) {
+            for (const auto& triangle : triangles) {
+                res += triangle.circumscribedCircle().radius() + triangle.inscribedCircle().radius() +
+                       triangle.centroid().x + triangle.orthocenter().x + triangle.ninePointsCircle().center().x;
+            }
+        } else if (state.range(0) == 1) {
+            for (const auto& triangle : triangles) {
+                TriangleCenters c = triangle.centers();
+                res += c.circumradius + c.inradius + c.centroid.x + c.orthocenter.x + c.nine_point_center.x;
+            }
+        } else {
+            soa.centers(batch);
+            res += batch.circumradius.back() + batch.nine_point_x.back();
+        }
+        benchmark::DoNotOptimize(res);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_TriangleCenters)->ArgsProduct({{0, 1, 2}, {1 << 10, 1 << 20}});
+
+struct TemporaryFile {  // removed at exit
+    std::string path;
+
+    ~TemporaryFile() {
+        std::remove(this->path.c_str());
+    }
+};
+
+const std::string& ShapeFile(size_t count) {  // MixedScene(count) shapes written once per count to a temporary file
+    static std::map<size_t, TemporaryFile> files;
+    auto it = files.find(count);
+    if (it == files.end()) {
+        std::string path = std::string(P_tmpdir) + "/geometry_bench_shapes_" + std::to_string(count) + ".bin";
+        it = files.emplace(count, TemporaryFile()).first;  // constructed in place: a copy would remove the file
+        it->second.path = path;
+        std::ofstream out(path, std::ios::binary);
+        ShapeWriter(out).write(MixedScene(count).store);
+    }
+    return it->second.path;
+}
+
+// Loading shapes from a file in the page cache: 0 raw read of the bytes (the I/O floor), 1 ShapeReader over an
+// ifstream, 2 ShapeReader over a MappedFile
+static void BM_ShapeFileLoad(benchmark::State& state) {
+    const std::string& path = ShapeFile(1 << 20);
+    size_t bytes = 0;
+    for (auto _ : state) {
+        ShapeStore store;
+        if (state.range(0) == 0) {
+            std::ifstream file(path, std::ios::binary);
+            std::vector<char> buffer(kShapeReaderBuffer);
+            while (file.read(buffer.data(), buffer.size()) or file.gcount() > 0) {
+                bytes += file.gcount();
+            }
+        } else if (state.range(0) == 1) {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            size_t size = file.tellg();
+            file.seekg(0);
+            ShapeReader(file).readAll(store);
+            bytes += size;
+        } else {
+            MappedFile file(path);
+            ShapeReader(file.data(), file.size()).readAll(store);
+            bytes += file.size();
+        }
+        benchmark::DoNotOptimize(store.size());
+    }
+    state.SetItemsProcessed(state.iterations() * (1 << 20));
+    if (bytes > 0) {
+        state.SetBytesProcessed(bytes);
+    }
+}
+BENCHMARK(BM_ShapeFileLoad)->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
+
+// Area, perimeter and bounding box of a whole scene: 0 one thread over Shape*, 1 measureScene over Shape*,
+// 2 measureScene over a ShapeStore. Scales with the cores of the machine running it.
+static void BM_SceneMeasure(benchmark::State& state) {
+    MixedScene scene(state.range(1));
+    for (auto _ : state) {
+        SceneMeasures res;
+        if (state.range(0) == 0) {
+            for (auto shape : scene.shapes) {
+                res.area += shape->area();
+                res.perimeter += shape->perimeter();
+                res.box.extend(shape->boundingBox());
+            }
+        } else {
+            res = state.range(0) == 1 ? measureScene(scene.shapes) : measureScene(scene.store);
+        }
+        benchmark::DoNotOptimize(res);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+    state.counters["threads"] = hardwareThreads();
+}
+BENCHMARK(BM_SceneMeasure)->ArgsProduct({{0, 1, 2}, {1 << 16, 1 << 20}})->UseRealTime();
+
+// Area and perimeter of a polygon: 0 Polygon, 1 PolygonSoA (doubles), 2 CompactPolygon<float>,
+// 3 CompactPolygon<int32_t>; bytes are those of the stored vertices. 2^16 vertices stay in cache, 2^23 do not.
+static void BM_CompactPolygonMeasure(benchmark::State& state) {
+    Polygon polygon = NoisyCircle(state.range(1));
+    PolygonSoA soa(polygon);
+    CompactPolygon<float> as_float(polygon);
+    CompactPolygon<int32_t> as_fixed(polygon);
+    for (auto _ : state) {
+        double res;
+        switch (state.range(0)) {
+            case 0: res = polygon.area() + polygon.perimeter(); break;
+            case 1: res = soa.area() + soa.perimeter(); break;
+            case 2: res = as_float.area() + as_float.perimeter(); break;
+            default: res = as_fixed.area() + as_fixed.perimeter(); break;
+        }
+        benchmark::DoNotOptimize(res);
+    }
+    state.SetBytesProcessed(state.iterations() * 2 * state.range(1) * (state.range(0) < 2 ? 16 : 8));
+}
+BENCHMARK(BM_CompactPolygonMeasure)->ArgsProduct({{0, 1, 2, 3}, {1 << 16, 1 << 23}});
+
+// Reflection of 2^16 points in a line: 0 the old per-point formula (coefficient vector, divisions per point),
+// 1 Line::reflection per point, 2 the batched Line::reflection
+static void BM_LineReflection(benchmark::State& state) {
+    auto points = RandomPoints(1 << 16);
+    std::vector<Point> out(points.size());
+    Line line(Point(1, 0), Point(3, 4));
+    for (auto _ : state) {
+        if (state.range(0) == 0) {
+            for (size_t i = 0; i < points.size(); ++i) {
+                std::vector<double> coeffs = line.getLineCoeffs();
+                double t = (coeffs[0] * points[i].x + coeffs[1] * points[i].y + coeffs[2]) /
+                           calcSqrSum(coeffs[0], coeffs[1]);
+                out[i] = Point(points[i].x - 2 * t * coeffs[0], points[i].y - 2 * t * coeffs[1]);
+            }
+        } else if (state.range(0) == 1) {
+            for (size_t i = 0; i < points.size(); ++i) {
+                out[i] = line.reflection(points[i]);
+            }
+        } else {
+            line.reflection(points.data(), points.size(), out.data());
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_LineReflection)->DenseRange(0, 2);
+
+// Build 2^20 small polygons (triangles to hexagons) and sum their areas: 0 a vector of Polygon, a vertex vector
+// each, 1 one reserved PolygonArena; counters per polygon: heap allocations and, given a PMU, cache misses
+static void BM_PolygonArena(benchmark::State& state) {
+    const size_t count = 1 << 20;
+    auto points = RandomPoints(count + 6, 1000);
+    std::vector<Polygon> polygons;
+    PolygonArena arena;
+    CacheMissCounter misses;
+    size_t allocated = 0;
+    long long missed = 0;
+    counting_allocations = true;
+    for (auto _ : state) {
+        size_t before = allocations;
+        long long missed_before = misses.read();
+        double total = 0;
+        if (state.range(0) == 0) {
+            polygons.clear();
+            polygons.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                polygons.emplace_back(std::vector<Point>(points.begin() + i, points.begin() + i + 3 + i % 4));
+            }
+            for (const auto& polygon : polygons) {
+                total += polygon.Polygon::area();
+            }
+        } else {
+            arena.clear();
+            arena.reserve(count, count * 9 / 2);
+            for (size_t i = 0; i < count; ++i) {
+                arena.add(VertexSpan(points.data() + i, 3 + i % 4));
+            }
+            for (size_t i = 0; i < arena.size(); ++i) {
+                total += polygonArea(arena[i]);
+            }
+        }
+        benchmark::DoNotOptimize(total);
+        missed += misses.read() - missed_before;
+        allocated += allocations - before;
+    }
+    counting_allocations = false;
+    state.SetItemsProcessed(state.iterations() * count);
+    state.counters["allocs/polygon"] = double(allocated) / (state.iterations() * count);
+    if (misses.available()) {
+        state.counters["misses/polygon"] = double(missed) / (state.iterations() * count);
+    }
+}
+BENCHMARK(BM_PolygonArena)->DenseRange(0, 1)->Unit(benchmark::kMillisecond);
+
+// Per-type suite: construction, area, perimeter, every transform and equality for each shape type. Polygons take
+// the vertex count as the last argument; the closed-form shapes are built from the first vertices of a square.
+template <class T>
+T MakeShape(const std::vector<Point>& vertices);
+
+template <>
+Polygon MakeShape<Polygon>(const std::vector<Point>& vertices) {
+    return Polygon(vertices);
+}
+
+template <>
+Ellipse MakeShape<Ellipse>(const std::vector<Point>& vertices) {
+    return Ellipse(vertices[0], vertices[1], 3 * calcDistance(vertices[0], vertices[1]));
+}
+
+template <>
+Circle MakeShape<Circle>(const std::vector<Point>& vertices) {
+    return Circle(vertices[0], calcDistance(vertices[0], vertices[1]));
+}
+
+template <>
+Rectangle MakeShape<Rectangle>(const std::vector<Point>& vertices) {
+    return Rectangle(vertices[0], vertices[2], 1.5);
+}
+
+template <>
+Square MakeShape<Square>(const std::vector<Point>& vertices) {
+    return Square(vertices[0], vertices[2]);
+}
+
+template <>
+Triangle MakeShape<Triangle>(const std::vector<Point>& vertices) {
+    return Triangle(vertices[0], vertices[1], vertices[2]);
+}
+
+template <class T>
+void ShapeVertexCounts(benchmark::internal::Benchmark* benchmark) {
+    if (std::is_same<T, Polygon>::value) {
+        benchmark->RangeMultiplier(16)->Range(16, 1 << 16);
+    } else {
+        benchmark->Arg(4);
+    }
+}
+
+template <class T>
+void ShapeTransforms(benchmark::internal::Benchmark* benchmark) {  // 0 rotate, 1 reflex(point), 2 reflex(line), 3 scale
+    for (int64_t transform = 0; transform < 4; ++transform) {
+        if (std::is_same<T, Polygon>::value) {
+            for (int64_t count = 16; count <= (1 << 16); count *= 16) {
+                benchmark->Args({transform, count});
+            }
+        } else {
+            benchmark->Args({transform, 4});
+        }
+    }
+}
+
+template <class T>
+static void BM_ShapeConstruct(benchmark::State& state) {
+    std::vector<Point> vertices = RegularPolygon(state.range(0)).getVertices();
+    for (auto _ : state) {
+        T shape = MakeShape<T>(vertices);
+        benchmark::DoNotOptimize(&shape);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_ShapeConstruct, Polygon)->Apply(ShapeVertexCounts<Polygon>);
+BENCHMARK_TEMPLATE(BM_ShapeConstruct, Ellipse)->Apply(ShapeVertexCounts<Ellipse>);
+BENCHMARK_TEMPLATE(BM_ShapeConstruct, Circle)->Apply(ShapeVertexCounts<Circle>);
+BENCHMARK_TEMPLATE(BM_ShapeConstruct, Rectangle)->Apply(ShapeVertexCounts<Rectangle>);
+BENCHMARK_TEMPLATE(BM_ShapeConstruct, Square)->Apply(ShapeVertexCounts<Square>);
+BENCHMARK_TEMPLATE(BM_ShapeConstruct, Triangle)->Apply(ShapeVertexCounts<Triangle>);
+
+template <class T>
+static void BM_ShapeArea(benchmark::State& state) {
+    T shape = MakeShape<T>(RegularPolygon(state.range(0)).getVertices());
+    Shape* dynamic = &shape;  // virtual calls, as through a Shape* scene
+    benchmark::DoNotOptimize(dynamic);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dynamic->area());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_ShapeArea, Polygon)->Apply(ShapeVertexCounts<Polygon>);
+BENCHMARK_TEMPLATE(BM_ShapeArea, Ellipse)->Apply(ShapeVertexCounts<Ellipse>);
+BENCHMARK_TEMPLATE(BM_ShapeArea, Circle)->Apply(ShapeVertexCounts<Circle>);
+BENCHMARK_TEMPLATE(BM_ShapeArea, Rectangle)->Apply(ShapeVertexCounts<Rectangle>);
+BENCHMARK_TEMPLATE(BM_ShapeArea, Square)->Apply(ShapeVertexCounts<Square>);
+BENCHMARK_TEMPLATE(BM_ShapeArea, Triangle)->Apply(ShapeVertexCounts<Triangle>);
+
+template <class T>
+static void BM_ShapePerimeter(benchmark::State& state) {
+    T shape = MakeShape<T>(RegularPolygon(state.range(0)).getVertices());
+    Shape* dynamic = &shape;
+    benchmark::DoNotOptimize(dynamic);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dynamic->perimeter());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_ShapePerimeter, Polygon)->Apply(ShapeVertexCounts<Polygon>);
+BENCHMARK_TEMPLATE(BM_ShapePerimeter, Ellipse)->Apply(ShapeVertexCounts<Ellipse>);
+BENCHMARK_TEMPLATE(BM_ShapePerimeter, Circle)->Apply(ShapeVertexCounts<Circle>);
+BENCHMARK_TEMPLATE(BM_ShapePerimeter, Rectangle)->Apply(ShapeVertexCounts<Rectangle>);
+BENCHMARK_TEMPLATE(BM_ShapePerimeter, Square)->Apply(ShapeVertexCounts<Square>);
+BENCHMARK_TEMPLATE(BM_ShapePerimeter, Triangle)->Apply(ShapeVertexCounts<Triangle>);
+
+template <class T>
+static void BM_ShapeTransform(benchmark::State& state) {
+    T shape = MakeShape<T>(RegularPolygon(state.range(1)).getVertices());
+    Shape* dynamic = &shape;
+    benchmark::DoNotOptimize(dynamic);
+    Point center(1, 1);
+    Line axis(Point(0, 1), Point(1, 3));
+    double coeff = 2;
+    for (auto _ : state) {
+        switch (state.range(0)) {
+            case 0: dynamic->rotate(center, 1); break;
+            case 1: dynamic->reflex(center); break;
+            case 2: dynamic->reflex(axis); break;
+            default: dynamic->scale(center, coeff); coeff = 1 / coeff; break;  // alternate, so the shape stays bounded
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_ShapeTransform, Polygon)->Apply(ShapeTransforms<Polygon>);
+BENCHMARK_TEMPLATE(BM_ShapeTransform, Ellipse)->Apply(ShapeTransforms<Ellipse>);
+BENCHMARK_TEMPLATE(BM_ShapeTransform, Circle)->Apply(ShapeTransforms<Circle>);
+BENCHMARK_TEMPLATE(BM_ShapeTransform, Rectangle)->Apply(ShapeTransforms<Rectangle>);
+BENCHMARK_TEMPLATE(BM_ShapeTransform, Square)->Apply(ShapeTransforms<Square>);
+BENCHMARK_TEMPLATE(BM_ShapeTransform, Triangle)->Apply(ShapeTransforms<Triangle>);
+
+template <class T>
+static void BM_ShapeEquality(benchmark::State& state) {  // equal shapes, the worst case of every comparison
+    T lhs = MakeShape<T>(RegularPolygon(state.range(0)).getVertices());
+    T rhs = lhs;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs == rhs);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_ShapeEquality, Polygon)->Apply(ShapeVertexCounts<Polygon>);
+BENCHMARK_TEMPLATE(BM_ShapeEquality, Ellipse)->Apply(ShapeVertexCounts<Ellipse>);
+BENCHMARK_TEMPLATE(BM_ShapeEquality, Circle)->Apply(ShapeVertexCounts<Circle>);
+BENCHMARK_TEMPLATE(BM_ShapeEquality, Rectangle)->Apply(ShapeVertexCounts<Rectangle>);
+BENCHMARK_TEMPLATE(BM_ShapeEquality, Square)->Apply(ShapeVertexCounts<Square>);
+BENCHMARK_TEMPLATE(BM_ShapeEquality, Triangle)->Apply(ShapeVertexCounts<Triangle>);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+#include "geometry.h"
+#include "polygon_soa.h"
+
+
+// Polygons stored with 32-bit coordinates: float, or int32_t fixed point. A vertex takes 8 bytes instead of 16.
+// Coordinates are kept relative to a CoordinateFrame, world = origin + unit * stored. Every stored value converts to
+// double exactly, so orientation and point-in-polygon tests run the adaptive predicates on exact inputs and stay
+// robust for the stored geometry. Polygons sharing a frame share their rounding, e.g. the tiles of one map.
+
+const double kFixedRange = 1 << 30;  // fitted frames keep fixed-point values within +-2^30
+
+
+struct CoordinateFrame {
+    Point origin;
+    double unit = 1;
+};
+
+
+template <class Coord>
+CoordinateFrame fittingFrame(const BoundingBox& box) {  // centered on the box; fixed point spans it with 2^31 steps
+    CoordinateFrame res;
+    if (!box.empty()) {
+        res.origin = box.center();
+        double half = std::max(box.max.x - box.min.x, box.max.y - box.min.y) * 0.5;
+        if (std::is_integral<Coord>::value and (half > 0)) {
+            res.unit = half / kFixedRange;
+        }
+    }
+    return res;
+}
+
+
+template <class Coord>
+class CompactPolygon {
+    static_assert(std::is_same<Coord, float>::value or std::is_same<Coord, int32_t>::value,
+                  "coordinates are float or int32_t fixed point");
+
+public:
+    explicit CompactPolygon(const Polygon& polygon)
+        : CompactPolygon(polygon, fittingFrame<Coord>(polygon.boundingBox())) {}
+
+    CompactPolygon(const Polygon& polygon, const CoordinateFrame& frame) : frame(frame) {
+        const auto& vertices = polygon.getVertices();
+        this->xs.resize(vertices.size());
+        this->ys.resize(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            this->xs[i] = this->encode(vertices[i].x, frame.origin.x);
+            this->ys[i] = this->encode(vertices[i].y, frame.origin.y);
+        }
+    }
+
+    size_t verticesCount() const {
+        return this->xs.size();
+    }
+
+    const CoordinateFrame& getFrame() const {
+        return this->frame;
+    }
+
+    Point vertex(size_t i) const {
+        return Point(this->frame.origin.x + this->frame.unit * double(this->xs[i]),
+                     this->frame.origin.y + this->frame.unit * double(this->ys[i]));
+    }
+
+    Polygon toPolygon() const {
+        std::vector<Point> vertices(this->xs.size());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            vertices[i] = this->vertex(i);
+        }
+        return Polygon(vertices);
+    }
+
+    // Shoelace and edge lengths over blocks widened to double on the stack: GCC does not vectorize the mixed-width
+    // loop directly, but does both the widening and the chainCrossSum / chainLength kernels of polygon_soa.h.
+    double area() const {
+        if (this->xs.size() < 3) {
+            return 0;
+        }
+        double twice = this->reduceBlocks(shoelace);
+        return 0.5 * std::abs(twice) * this->frame.unit * this->frame.unit;
+    }
+
+    double perimeter() const {
+        if (this->xs.size() < 2) {
+            return 0;
+        }
+        return this->reduceBlocks(chainLength) * this->frame.unit;
+    }
+
+    BoundingBox boundingBox() const {
+        if (this->xs.empty()) {
+            return BoundingBox();
+        }
+        auto x = std::minmax_element(this->xs.begin(), this->xs.end());
+        auto y = std::minmax_element(this->ys.begin(), this->ys.end());
+        const Point& o = this->frame.origin;
+        double unit = this->frame.unit;
+        return BoundingBox(Point(o.x + unit * *x.first, o.y + unit * *y.first),
+                           Point(o.x + unit * *x.second, o.y + unit * *y.second));
+    }
+
+    // 1 counterclockwise, -1 clockwise, 0 degenerate, as polygonOrientation but without a widened vertex copy: the
+    // exact turn at the lexicographically least vertex, or the sign of the shoelace sum when that turn is flat
+    int orientation() const {
+        size_t n = this->xs.size();
+        if (n < 3) {
+            return 0;
+        }
+        size_t k = 0;
+        for (size_t i = 1; i < n; ++i) {
+            if ((this->xs[i] < this->xs[k]) or ((this->xs[i] == this->xs[k]) and (this->ys[i] < this->ys[k]))) {
+                k = i;
+            }
+        }
+        size_t prev = (k + n - 1) % n, next = (k + 1) % n;
+        double turn = orient2d(this->xs[prev], this->ys[prev], this->xs[k], this->ys[k], this->xs[next],
+                               this->ys[next]);
+        if (turn == 0) {
+            turn = this->reduceBlocks(shoelace);
+        }
+        return (turn > 0) - (turn < 0);
+    }
+
+    // Crossing number with exact orientation signs in frame coordinates; the boundary counts as inside.
+    bool containsPoint(const Point& p) const {
+        double px = (p.x - this->frame.origin.x) / this->frame.unit;
+        double py = (p.y - this->frame.origin.y) / this->frame.unit;
+        size_t n = this->xs.size();
+        bool inside = false;
+        for (size_t e = 0; e < n; ++e) {
+            size_t f = e + 1 < n ? e + 1 : 0;
+            double x1 = this->xs[e], y1 = this->ys[e], x2 = this->xs[f], y2 = this->ys[f];
+            double t = orient2d(x1, y1, x2, y2, px, py);
+            if ((t == 0) and (px >= std::min(x1, x2)) and (px <= std::max(x1, x2)) and (py >= std::min(y1, y2)) and
+                (py <= std::max(y1, y2))) {
+                return true;
+            }
+            if (((y1 > py) != (y2 > py)) and ((t > 0) == (y2 > y1))) {
+                inside = !inside;
+            }
+        }
+        return inside;
+    }
+
+private:
+    static double shoelace(const double* x, const double* y, size_t m) {  // twice the signed area of a block
+        return chainCrossSum(x, y, m, 0, 0);
+    }
+
+    static constexpr size_t kBlock = 512;  // vertices widened at once, two 4 KiB stack arrays
+
+    // Sum of edge(x, y, m) over consecutive blocks of the closed vertex sequence widened to double; consecutive
+    // blocks share a vertex, so edge sees every edge (including the closing one) exactly once.
+    template <class Edge>
+    double reduceBlocks(Edge edge) const {
+        size_t n = this->xs.size();
+        double x[kBlock + 1], y[kBlock + 1];
+        double res = 0;
+        for (size_t begin = 0; begin < n; begin += kBlock) {
+            size_t m = std::min(kBlock, n - begin);
+            for (size_t i = 0; i < m; ++i) {
+                x[i] = this->xs[begin + i];
+                y[i] = this->ys[begin + i];
+            }
+            size_t next = begin + m < n ? begin + m : 0;
+            x[m] = this->xs[next];
+            y[m] = this->ys[next];
+            res += edge(x, y, m + 1);
+        }
+        return res;
+    }
+
+    CoordinateFrame frame;
+    std::vector<Coord> xs;
+    std::vector<Coord> ys;
+
+    Coord encode(double value, double origin) const {
+        double local = (value - origin) / this->frame.unit;
+        if constexpr (std::is_integral<Coord>::value) {  // nearest step, saturating at the int32 range
+            local = std::max(-2147483648.0, std::min(std::nearbyint(local), 2147483647.0));
+        }
+        return Coord(local);
+    }
+};
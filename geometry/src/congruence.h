@@ -0,0 +1,167 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+
+#include "geometry.h"
+
+
+enum class PolygonEquality {
+    Coincidence,  // same vertices, any start vertex and direction (Polygon::operator==)
+    Congruence,  // equal up to rotation, translation and reflection
+    Similarity  // congruent after scaling
+};
+
+
+// Canonical form of a polygon: per-vertex tuples quantized to integers, rotated by Booth's algorithm
+// to the lexicographically least start and taken over both traversal directions (or mirror images).
+// Equal polygons get equal forms in O(n); values within quantum of a rounding boundary may still differ.
+class PolygonCanonicalForm {
+public:
+    explicit PolygonCanonicalForm(const Polygon& polygon, PolygonEquality mode = PolygonEquality::Coincidence,
+                                  double quantum = 1e-6) : mode(mode) {
+        std::vector<Point> vertices = polygon.getVertices();
+        std::vector<Token> seq, alt;
+        if (mode == PolygonEquality::Coincidence) {
+            seq = coordinates(vertices, quantum);
+            std::reverse(vertices.begin(), vertices.end());
+            alt = coordinates(vertices, quantum);
+        } else {
+            if (signedArea(vertices) < 0) {  // counterclockwise, so turns have a fixed sign
+                std::reverse(vertices.begin(), vertices.end());
+            }
+            seq = turns(vertices, mode, quantum);
+            for (auto& vertex : vertices) {  // mirror image, again counterclockwise
+                vertex.x = -vertex.x;
+            }
+            std::reverse(vertices.begin(), vertices.end());
+            alt = turns(vertices, mode, quantum);
+        }
+        rotateToLeast(seq);
+        rotateToLeast(alt);
+        this->tokens = std::min(seq, alt);
+    }
+
+    bool operator==(const PolygonCanonicalForm& rhs) const {
+        return (this->mode == rhs.mode) and (this->tokens == rhs.tokens);
+    }
+
+    bool operator!=(const PolygonCanonicalForm& rhs) const {
+        return !(*this == rhs);
+    }
+
+    size_t hash() const {
+        size_t res = std::hash<int>()(static_cast<int>(this->mode));
+        for (const auto& token : this->tokens) {
+            for (long long value : token) {
+                res ^= std::hash<long long>()(value) + 0x9e3779b97f4a7c15ULL + (res << 6) + (res >> 2);
+            }
+        }
+        return res;
+    }
+
+private:
+    typedef std::array<long long, 3> Token;
+
+    static long long quantize(double value, double quantum) {
+        return std::llround(value / quantum);
+    }
+
+    static double signedArea(const std::vector<Point>& vertices) {
+        double res = 0;
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            const Point& p = vertices[i];
+            const Point& q = vertices[(i + 1) % vertices.size()];
+            res += p.x * q.y - q.x * p.y;
+        }
+        return 0.5 * res;
+    }
+
+    static std::vector<Token> coordinates(const std::vector<Point>& vertices, double quantum) {
+        std::vector<Token> res(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            res[i] = {quantize(vertices[i].x, quantum), quantize(vertices[i].y, quantum), 0};
+        }
+        return res;
+    }
+
+    // (edge length, cos and sin of the turn at its start); lengths are relative to the perimeter for similarity
+    static std::vector<Token> turns(const std::vector<Point>& vertices, PolygonEquality mode, double quantum) {
+        size_t n = vertices.size();
+        std::vector<double> lengths(n);
+        double perimeter = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const Point& p = vertices[i];
+            const Point& q = vertices[(i + 1) % n];
+            lengths[i] = sqrt(calcSqrSum(q.x - p.x, q.y - p.y));
+            perimeter += lengths[i];
+        }
+        double unit = (mode == PolygonEquality::Similarity and perimeter > 0) ? perimeter : 1.0;
+        std::vector<Token> res(n);
+        for (size_t i = 0; i < n; ++i) {
+            const Point& prev = vertices[(i + n - 1) % n];
+            const Point& p = vertices[i];
+            const Point& next = vertices[(i + 1) % n];
+            double ax = p.x - prev.x, ay = p.y - prev.y;
+            double bx = next.x - p.x, by = next.y - p.y;
+            double norm = lengths[(i + n - 1) % n] * lengths[i];
+            double cos_t = norm > 0 ? (ax * bx + ay * by) / norm : 1.0;
+            double sin_t = norm > 0 ? (ax * by - ay * bx) / norm : 0.0;
+            res[i] = {quantize(lengths[i] / unit, quantum), quantize(cos_t, quantum), quantize(sin_t, quantum)};
+        }
+        return res;
+    }
+
+    static void rotateToLeast(std::vector<Token>& seq) {  // Booth's least rotation, O(n)
+        size_t n = seq.size();
+        if (n == 0) {
+            return;
+        }
+        std::vector<long long> f(2 * n, -1);
+        size_t k = 0;
+        for (size_t j = 1; j < 2 * n; ++j) {
+            const Token& sj = seq[j % n];
+            long long i = f[j - k - 1];
+            while ((i != -1) and (sj != seq[(k + i + 1) % n])) {
+                if (sj < seq[(k + i + 1) % n]) {
+                    k = j - i - 1;
+                }
+                i = f[i];
+            }
+            if ((i == -1) and (sj != seq[(k + i + 1) % n])) {
+                if (sj < seq[(k + i + 1) % n]) {
+                    k = j;
+                }
+                f[j - k] = -1;
+            } else {
+                f[j - k] = i + 1;
+            }
+        }
+        std::rotate(seq.begin(), seq.begin() + k % n, seq.end());
+    }
+
+    PolygonEquality mode;
+    std::vector<Token> tokens;
+};
+
+
+struct PolygonCanonicalFormHash {  // for std::unordered_set<PolygonCanonicalForm, PolygonCanonicalFormHash>
+    size_t operator()(const PolygonCanonicalForm& form) const {
+        return form.hash();
+    }
+};
+
+
+bool isCongruent(const Polygon& lhs, const Polygon& rhs) {
+    return (lhs.verticesCount() == rhs.verticesCount()) and
+           (PolygonCanonicalForm(lhs, PolygonEquality::Congruence) == PolygonCanonicalForm(rhs, PolygonEquality::Congruence));
+}
+
+
+bool isSimilar(const Polygon& lhs, const Polygon& rhs) {
+    return (lhs.verticesCount() == rhs.verticesCount()) and
+           (PolygonCanonicalForm(lhs, PolygonEquality::Similarity) == PolygonCanonicalForm(rhs, PolygonEquality::Similarity));
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <istream>
+
+#include "geometry.h"
+#include "parallel.h"
+
+
+const size_t kParallelSortThreshold = 1 << 16;
+
+// sorts chunks on separate threads, then merges neighbouring runs pairwise, also in parallel
+void parallelSortPoints(std::vector<Point>& points) {
+    size_t chunks = std::min(hardwareThreads(), points.size() / (kParallelSortThreshold / 2));
+    if (chunks < 2) {
+        std::sort(points.begin(), points.end(), LexicographicLess());
+        return;
+    }
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t i = 0; i <= chunks; ++i) {
+        bounds[i] = points.size() * i / chunks;
+    }
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < chunks; ++i) {
+        threads.emplace_back([&points, &bounds, i]() {
+            std::sort(points.begin() + bounds[i], points.begin() + bounds[i + 1], LexicographicLess());
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (size_t width = 1; width < chunks; width *= 2) {
+        threads.clear();
+        for (size_t i = 0; i + width < chunks; i += 2 * width) {
+            auto first = points.begin() + bounds[i];
+            auto middle = points.begin() + bounds[i + width];
+            auto last = points.begin() + bounds[std::min(i + 2 * width, chunks)];
+            threads.emplace_back([first, middle, last]() {
+                std::inplace_merge(first, middle, last, LexicographicLess());
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+}
+
+
+// Andrew's monotone chain over lexicographically sorted points; counterclockwise, collinear points dropped
+std::vector<Point> monotoneChain(const std::vector<Point>& sorted) {
+    size_t n = sorted.size();
+    if (n < 3) {
+        std::vector<Point> res(sorted);
+        res.erase(std::unique(res.begin(), res.end()), res.end());
+        return res;
+    }
+    std::vector<Point> hull(2 * n);
+    size_t k = 0;
+    for (size_t i = 0; i < n; ++i) {  // lower chain
+        while ((k >= 2) and (orientation(hull[k - 2], hull[k - 1], sorted[i]) <= 0)) {
+            --k;
+        }
+        hull[k++] = sorted[i];
+    }
+    for (size_t i = n - 1, lower = k + 1; i-- > 0;) {  // upper chain
+        while ((k >= lower) and (orientation(hull[k - 2], hull[k - 1], sorted[i]) <= 0)) {
+            --k;
+        }
+        hull[k++] = sorted[i];
+    }
+    hull.resize(k - 1);  // the last point repeats the first one
+    return hull;
+}
+
+
+Polygon convexHull(std::vector<Point> points) {
+    parallelSortPoints(points);
+    return Polygon(monotoneChain(points));
+}
+
+
+// Hull of a point cloud fed in pieces: only the current hull and one buffered chunk are kept in memory
+class StreamingConvexHull {
+public:
+    explicit StreamingConvexHull(size_t chunk = 1 << 20) : chunk(std::max<size_t>(chunk, 1)) {}
+
+    void add(const Point& p) {
+        this->buffer.push_back(p);
+        if (this->buffer.size() >= this->chunk) {
+            this->flush();
+        }
+    }
+
+    void add(const std::vector<Point>& points) {
+        for (const auto& p : points) {
+            this->add(p);
+        }
+    }
+
+    void add(std::istream& in) {  // whitespace separated "x y" pairs until the end of the stream
+        double x, y;
+        while (in >> x >> y) {
+            this->add(Point(x, y));
+        }
+    }
+
+    size_t pointsCount() const {
+        return this->count + this->buffer.size();
+    }
+
+    Polygon hull() {
+        this->flush();
+        return Polygon(this->current);
+    }
+
+private:
+    void flush() {
+        if (this->buffer.empty()) {
+            return;
+        }
+        this->count += this->buffer.size();
+        this->buffer.insert(this->buffer.end(), this->current.begin(), this->current.end());
+        parallelSortPoints(this->buffer);
+        this->current = monotoneChain(this->buffer);
+        this->buffer.clear();
+    }
+
+    size_t chunk;
+    size_t count = 0;
+    std::vector<Point> buffer;
+    std::vector<Point> current;
+};
@@ -2,6 +2,10 @@
 
 #include <vector>
 #include <cmath>
+#include <algorithm>
+#include <optional>
+
+#include "predicates.h"
 
 
 const double EPS = 1e-9;
@@ -16,7 +20,8 @@ struct Point {
     Point(double x, double y) : x(x), y(y) {}
 
     bool operator==(const Point& rhs) const {
-        return ((abs(this->x - rhs.x) < EPS) and (abs(this->y - rhs.y) < EPS));
+        double scale = std::max({1.0, std::abs(this->x), std::abs(this->y), std::abs(rhs.x), std::abs(rhs.y)});
+        return ((std::abs(this->x - rhs.x) < EPS * scale) and (std::abs(this->y - rhs.y) < EPS * scale));
     }
 
     bool operator!=(const Point& rhs) const {
@@ -25,6 +30,57 @@ struct Point {
 };
 
 
+struct BoundingBox {  // axis-aligned, empty when min > max
+    Point min;
+    Point max;
+
+    BoundingBox() : min(INFINITY, INFINITY), max(-INFINITY, -INFINITY) {}
+
+    BoundingBox(Point min, Point max) : min(min), max(max) {}
+
+    bool empty() const {
+        return (this->min.x > this->max.x) or (this->min.y > this->max.y);
+    }
+
+    void extend(const Point& p) {
+        this->min.x = std::min(this->min.x, p.x);
+        this->min.y = std::min(this->min.y, p.y);
+        this->max.x = std::max(this->max.x, p.x);
+        this->max.y = std::max(this->max.y, p.y);
+    }
+
+    void extend(const BoundingBox& box) {
+        this->min.x = std::min(this->min.x, box.min.x);
+        this->min.y = std::min(this->min.y, box.min.y);
+        this->max.x = std::max(this->max.x, box.max.x);
+        this->max.y = std::max(this->max.y, box.max.y);
+    }
+
+    bool contains(const Point& p) const {
+        return (this->min.x <= p.x) and (p.x <= this->max.x) and (this->min.y <= p.y) and (p.y <= this->max.y);
+    }
+
+    bool intersects(const BoundingBox& box) const {
+        return (this->min.x <= box.max.x) and (box.min.x <= this->max.x) and
+               (this->min.y <= box.max.y) and (box.min.y <= this->max.y);
+    }
+
+    Point center() const {
+        return Point((this->min.x + this->max.x) * 0.5, (this->min.y + this->max.y) * 0.5);
+    }
+
+    double area() const {
+        return this->empty() ? 0 : (this->max.x - this->min.x) * (this->max.y - this->min.y);
+    }
+
+    double sqrDistance(const Point& p) const {  // squared distance from the point to the box, 0 inside
+        double dx = std::max(std::max(this->min.x - p.x, 0.0), p.x - this->max.x);
+        double dy = std::max(std::max(this->min.y - p.y, 0.0), p.y - this->max.y);
+        return dx * dx + dy * dy;
+    }
+};
+
+
 double calcSqrSum(const double& x, const double& y) {  // calculate sum of squares
     return x * x + y * y;
 }
@@ -35,12 +91,46 @@ double calcDistance(const Point& p1, const Point& p2) {  // calculate distance b
 }
 
 
+bool lexicographicLess(const Point& lhs, const Point& rhs) {
+    return (lhs.x < rhs.x) or ((lhs.x == rhs.x) and (lhs.y < rhs.y));
+}
+
+
+double cross(const Point& o, const Point& a, const Point& b) {  // > 0 when o -> a -> b turns counterclockwise
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+
+double orientation(const Point& a, const Point& b, const Point& c) {  // exact sign of cross(a, b, c)
+    return orient2d(a.x, a.y, b.x, b.y, c.x, c.y);
+}
+
+
+double inCircle(const Point& a, const Point& b, const Point& c, const Point& d) {  // > 0: d inside, a, b, c ccw
+    return incircle(a.x, a.y, b.x, b.y, c.x, c.y, d.x, d.y);
+}
+
+
+struct LexicographicLess {  // function object, so std::sort inlines the comparison
+    bool operator()(const Point& lhs, const Point& rhs) const {
+        return lexicographicLess(lhs, rhs);
+    }
+};
+
+
+struct LineCoeffs {  // a * x + b * y + c = 0
+    double a;
+    double b;
+    double c;
+};
+
+
 class Line {
 public:
     Line(const Point &p1, const Point &p2) {  // (y2 - y1) * x + (x1 - x2) * y + (y1 * x2 - x1 * y2) = 0
         this->a = p2.y - p1.y;
         this->b = p1.x - p2.x;
-        this->c = p1.y * p2.x - p1.x * p2.y;
+        this->c = -(this->a * p1.x + this->b * p1.y);  // same value, without cancelling p1.y * p2.x - p1.x * p2.y
     }
 
     Line(double k, double b) : a(k), b(-1), c(b) {}  // k * x - y + b = 0
@@ -51,16 +141,62 @@ public:
         this->c = p.y - k * p.x;
     }
 
-    std::vector<double> getLineCoeffs() const {
+    std::vector<double> getLineCoeffs() const {  // allocates; coeffs() returns the same by value
         std::vector<double> coeffs{a, b, c};
         return coeffs;
     }
 
-    bool operator==(const Line &rhs) const {
-        double cf1 = abs(rhs.a - 0.0) >= EPS ? this->a / rhs.a : this->b / rhs.b;
-        double cf2 = abs(rhs.b - 0.0) >= EPS ? this->b / rhs.b : cf1;
-        double cf3 = abs(rhs.c - 0.0) >= EPS ? this->c / rhs.c : cf1;
-        return (abs(cf1 / cf2 - 1.0) < EPS) and (abs(cf1 / cf3 - 1.0) < EPS);
+    LineCoeffs coeffs() const {
+        return LineCoeffs{this->a, this->b, this->c};
+    }
+
+    double signedDistance(const Point& p) const {  // positive on the side the normal (a, b) points to
+        return (this->a * p.x + this->b * p.y + this->c) / sqrt(calcSqrSum(this->a, this->b));
+    }
+
+    Point projection(const Point& p) const {
+        double t = (this->a * p.x + this->b * p.y + this->c) / calcSqrSum(this->a, this->b);
+        return Point(p.x - t * this->a, p.y - t * this->b);
+    }
+
+    Point reflection(const Point& p) const {
+        double t = 2 * (this->a * p.x + this->b * p.y + this->c) / calcSqrSum(this->a, this->b);
+        return Point(p.x - t * this->a, p.y - t * this->b);
+    }
+
+    // Batched versions: the norm is inverted once, the loops are division-free and vectorize. out may equal points.
+    void signedDistance(const Point* points, size_t count, double* out) const {
+        double inv_norm = 1 / sqrt(calcSqrSum(this->a, this->b));
+        double a = this->a * inv_norm, b = this->b * inv_norm, c = this->c * inv_norm;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = a * points[i].x + b * points[i].y + c;
+        }
+    }
+
+    void projection(const Point* points, size_t count, Point* out) const {
+        this->moveAlongNormal(points, count, out, 1);
+    }
+
+    void reflection(const Point* points, size_t count, Point* out) const {
+        this->moveAlongNormal(points, count, out, 2);
+    }
+
+    std::optional<Point> intersection(const Line& rhs) const {  // nullopt for parallel or coinciding lines
+        double det = this->a * rhs.b - rhs.a * this->b;
+        if (std::abs(det) <= EPS * (std::abs(this->a) + std::abs(this->b)) * (std::abs(rhs.a) + std::abs(rhs.b))) {
+            return std::nullopt;
+        }
+        return Point((this->b * rhs.c - rhs.b * this->c) / det, (rhs.a * this->c - this->a * rhs.c) / det);
+    }
+
+    bool operator==(const Line &rhs) const {  // parallel within EPS radians, offsets equal relative to their size
+        double n1 = sqrt(calcSqrSum(this->a, this->b)), n2 = sqrt(calcSqrSum(rhs.a, rhs.b));
+        if (std::abs(det2(this->a, this->b, rhs.a, rhs.b)) > EPS * n1 * n2) {
+            return false;
+        }
+        double d1 = this->c / n1;  // signed distances from the origin along a common normal
+        double d2 = (this->a * rhs.a + this->b * rhs.b < 0 ? -rhs.c : rhs.c) / n2;
+        return std::abs(d1 - d2) <= EPS * std::max({1.0, std::abs(d1), std::abs(d2)});
     }
 
     bool operator!=(const Line &rhs) const {
@@ -69,22 +205,239 @@ public:
 
 private:
     double a, b, c;  // line coefficients: a * x + b * y + c = 0
+
+    void moveAlongNormal(const Point* points, size_t count, Point* out, double times) const {  // p - times * t * (a, b)
+        double k = times / calcSqrSum(this->a, this->b);
+        double ka = k * this->a, kb = k * this->b;
+        double a = this->a, b = this->b, c = this->c;
+        for (size_t i = 0; i < count; ++i) {
+            double x = points[i].x, y = points[i].y;
+            double t = a * x + b * y + c;
+            out[i].x = x - t * ka;
+            out[i].y = y - t * kb;
+        }
+    }
+};
+
+
+struct Rotation {  // precomputed cosine and sine of a counterclockwise angle, so one angle costs one cos and one sin
+    double cos;
+    double sin;
+
+    static Rotation degrees(double angle) {
+        return Rotation::radians(angle * M_PI / 180);
+    }
+
+    static Rotation radians(double angle) {
+        return Rotation{std::cos(angle), std::sin(angle)};
+    }
+
+    Rotation then(const Rotation& next) const {  // angles add
+        return Rotation{this->cos * next.cos - this->sin * next.sin, this->sin * next.cos + this->cos * next.sin};
+    }
+
+    Point apply(const Point& p) const {  // around the origin
+        return Point(p.x * this->cos - p.y * this->sin, p.x * this->sin + p.y * this->cos);
+    }
+};
+
+
+class AffineTransform {  // x' = m[0] * x + m[1] * y + m[2], y' = m[3] * x + m[4] * y + m[5]
+public:
+    AffineTransform() : m{1, 0, 0, 0, 1, 0} {}
+
+    AffineTransform(double m00, double m01, double m02, double m10, double m11, double m12)
+        : m{m00, m01, m02, m10, m11, m12} {}
+
+    AffineTransform then(const AffineTransform& next) const {  // this first, next afterwards
+        const double* n = next.m;
+        return AffineTransform(
+            n[0] * m[0] + n[1] * m[3], n[0] * m[1] + n[1] * m[4], n[0] * m[2] + n[1] * m[5] + n[2],
+            n[3] * m[0] + n[4] * m[3], n[3] * m[1] + n[4] * m[4], n[3] * m[2] + n[4] * m[5] + n[5]);
+    }
+
+    AffineTransform rotate(Point center, double angle) const {  // angle in degrees, counterclockwise
+        return this->rotate(center, Rotation::degrees(angle));
+    }
+
+    AffineTransform rotate(Point center, const Rotation& rotation) const {
+        double cos_a = rotation.cos, sin_a = rotation.sin;
+        return this->then(AffineTransform(cos_a, -sin_a, center.x - cos_a * center.x + sin_a * center.y,
+                                          sin_a, cos_a, center.y - sin_a * center.x - cos_a * center.y));
+    }
+
+    AffineTransform scale(Point center, double coeff) const {
+        return this->then(AffineTransform(coeff, 0, center.x * (1 - coeff), 0, coeff, center.y * (1 - coeff)));
+    }
+
+    AffineTransform reflex(Point center) const {
+        return this->scale(center, -1);
+    }
+
+    AffineTransform reflex(const Line& axis) const {  // p - 2 * (a * x + b * y + c) / (a^2 + b^2) * (a, b)
+        LineCoeffs coeffs = axis.coeffs();
+        double a = coeffs.a, b = coeffs.b, c = coeffs.c;
+        double k = 2 / calcSqrSum(a, b);
+        return this->then(AffineTransform(1 - k * a * a, -k * a * b, -k * a * c,
+                                          -k * a * b, 1 - k * b * b, -k * b * c));
+    }
+
+    double scaleFactor() const {  // length multiplier of a similarity transform
+        return sqrt(std::abs(m[0] * m[4] - m[1] * m[3]));
+    }
+
+    Point apply(const Point& p) const {
+        return Point(m[0] * p.x + m[1] * p.y + m[2], m[3] * p.x + m[4] * p.y + m[5]);
+    }
+
+    void apply(Point* points, size_t count) const {  // single pass, the loop vectorizes
+        const double m00 = m[0], m01 = m[1], m02 = m[2], m10 = m[3], m11 = m[4], m12 = m[5];
+        for (size_t i = 0; i < count; ++i) {
+            double x = points[i].x, y = points[i].y;
+            points[i].x = m00 * x + m01 * y + m02;
+            points[i].y = m10 * x + m11 * y + m12;
+        }
+    }
+
+private:
+    double m[6];
 };
 
 
 class Shape {
 public:
+    virtual ~Shape() = default;
     virtual double perimeter() const { return 0; }
     virtual double area() const { return 0; }
     virtual bool operator==(const Shape& rhs) { return false; }
     virtual bool operator!=(const Shape& rhs) { return false; }
-    virtual void rotate(Point center, double angle) {}
-    virtual void reflex(Point center) {}
-    virtual void reflex(Line axis) {}
-    virtual void scale(Point center, double coeff) {}
+    virtual void transform(const AffineTransform&) {}  // the transform must be a similarity: rotate, scale, reflex
+    virtual void rotate(Point center, double angle) { this->transform(AffineTransform().rotate(center, angle)); }
+    virtual void rotate(Point center, const Rotation& rotation) {
+        this->transform(AffineTransform().rotate(center, rotation));
+    }
+    virtual void reflex(Point center) { this->transform(AffineTransform().reflex(center)); }
+    virtual void reflex(Line axis) { this->transform(AffineTransform().reflex(axis)); }
+    virtual void scale(Point center, double coeff) { this->transform(AffineTransform().scale(center, coeff)); }
+    virtual BoundingBox boundingBox() const { return BoundingBox(); }
+    virtual bool containsPoint(const Point&) const { return false; }  // boundary counts as inside
+
+    virtual std::vector<char> containsPoints(const std::vector<Point>& points) const {  // batched containsPoint
+        std::vector<char> res(points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            res[i] = this->containsPoint(points[i]);
+        }
+        return res;
+    }
+};
+
+
+class VertexSpan {  // non-owning view of consecutive vertices: a Polygon's vector or a slice of a PolygonArena
+public:
+    VertexSpan() = default;
+
+    VertexSpan(const Point* data, size_t count) : first(data), count(count) {}
+
+    VertexSpan(const std::vector<Point>& vertices) : first(vertices.data()), count(vertices.size()) {}  // implicit
+
+    size_t size() const {
+        return this->count;
+    }
+
+    bool empty() const {
+        return this->count == 0;
+    }
+
+    const Point* data() const {
+        return this->first;
+    }
+
+    const Point* begin() const {
+        return this->first;
+    }
+
+    const Point* end() const {
+        return this->first + this->count;
+    }
+
+    const Point& operator[](size_t i) const {
+        return this->first[i];
+    }
+
+private:
+    const Point* first = nullptr;
+    size_t count = 0;
 };
 
 
+int polygonOrientation(VertexSpan vertices) {  // 1 counterclockwise, -1 clockwise, 0 degenerate
+    if (vertices.size() < 3) {
+        return 0;
+    }
+    size_t n = vertices.size();
+    size_t k = std::min_element(vertices.begin(), vertices.end(), LexicographicLess()) - vertices.begin();
+    double turn = orientation(vertices[(k + n - 1) % n], vertices[k], vertices[(k + 1) % n]);  // convex corner
+    if (turn == 0) {  // repeated or collinear neighbours: fall back to the signed area
+        for (size_t i = 0; i < n; ++i) {
+            turn += cross(Point(), vertices[i], vertices[(i + 1) % n]);
+        }
+    }
+    return (turn > 0) - (turn < 0);
+}
+
+
+// Measures of the closed polygon through the given vertices; Polygon delegates to these, and they apply to the
+// vertices of a PolygonArena as they are.
+
+double polygonPerimeter(VertexSpan vertices) {
+    double res = 0;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        res += calcDistance(vertices[i], vertices[(i + 1) % vertices.size()]);
+    }
+    return res;
+}
+
+
+double polygonArea(VertexSpan vertices) {
+    double res = 0;
+    for (size_t i = 1; i + 1 < vertices.size(); ++i) {  // signed fan terms: shoelace, any simple polygon
+        double c1 = (vertices[i].x - vertices[0].x) * (vertices[i + 1].y - vertices[0].y);
+        double c2 = (vertices[i + 1].x - vertices[0].x) * (vertices[i].y - vertices[0].y);
+        res += c1 - c2;
+    }
+    return 0.5 * std::abs(res);
+}
+
+
+BoundingBox polygonBoundingBox(VertexSpan vertices) {
+    BoundingBox res;
+    for (const auto& vertex : vertices) {
+        res.extend(vertex);
+    }
+    return res;
+}
+
+
+bool polygonContainsPoint(VertexSpan vertices, const Point& p) {  // crossing number, the boundary counts as inside
+    bool inside = false;
+    for (size_t e = 0; e < vertices.size(); ++e) {
+        const Point& v1 = vertices[e];
+        const Point& v2 = vertices[(e + 1) % vertices.size()];
+        double dx = v2.x - v1.x;
+        double dy = v2.y - v1.y;
+        double t = dx * (p.y - v1.y) - (p.x - v1.x) * dy;
+        if ((t * t <= EPS * EPS * calcSqrSum(dx, dy)) and (p.x >= std::min(v1.x, v2.x) - EPS) and (p.x <= std::max(v1.x, v2.x) + EPS) and
+            (p.y >= std::min(v1.y, v2.y) - EPS) and (p.y <= std::max(v1.y, v2.y) + EPS)) {
+            return true;  // on the boundary
+        }
+        if (((v1.y > p.y) != (v2.y > p.y)) and ((t > 0) == (v2.y > v1.y))) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+
 double rotateX (const double& x, const double& y, const double& angle) {
     return x * cos(angle) - y * sin(angle);  // x coordinate after rotation
 }
@@ -95,6 +448,16 @@ double rotateY (const double& x, const double& y, const double& angle) {
 }
 
 
+double rotateX (const double& x, const double& y, const Rotation& rotation) {  // no trigonometry per call
+    return x * rotation.cos - y * rotation.sin;
+}
+
+
+double rotateY (const double& x, const double& y, const Rotation& rotation) {
+    return x * rotation.sin + y * rotation.cos;
+}
+
+
 class Polygon: public Shape {
 public:
     explicit Polygon(std::vector<Point> points) {
@@ -110,95 +473,86 @@ public:
     }
 
     double perimeter() const override {
-        double res = 0;
-        for (size_t i = 0; i < this->vertices.size(); ++i) {
-            res += calcDistance(this->vertices[i], this->vertices[(i + 1) % this->vertices.size()]);
-        }
-        return res;
+        return polygonPerimeter(this->vertices);
     }
 
     double area() const override {
-        double res = 0;
-        for (size_t i = 1; i < this->verticesCount() - 1; ++i) {
-            double c1 = (this->vertices[i].x - this->vertices[0].x) * (this->vertices[i + 1].y - this->vertices[0].y);
-            double c2 = (this->vertices[i + 1].x - this->vertices[0].x) * (this->vertices[i].y - this->vertices[0].y);
-            res += 0.5 * abs(c1 - c2);
+        return polygonArea(this->vertices);
+    }
+
+    int orientation() const {  // 1 counterclockwise, -1 clockwise, 0 degenerate
+        return polygonOrientation(this->vertices);
+    }
+
+    BoundingBox boundingBox() const override {
+        return polygonBoundingBox(this->vertices);
+    }
+
+    bool containsPoint(const Point& p) const override {  // crossing number, same rules as containsPoints
+        return polygonContainsPoint(this->vertices, p);
+    }
+
+    // edge-major crossing test: for every edge the loop over points is branch-free and vectorizes,
+    // points within EPS of an edge count as inside
+    std::vector<char> containsPoints(const std::vector<Point>& points) const override {
+        size_t n = points.size();
+        std::vector<int> inside(n, 0), boundary(n, 0);  // int, not char: char stores would alias the coordinates
+        int* in = inside.data();
+        int* on = boundary.data();
+        const Point* pts = points.data();
+        for (size_t e = 0; e < this->vertices.size(); ++e) {
+            const Point v1 = this->vertices[e];
+            const Point v2 = this->vertices[(e + 1) % this->vertices.size()];
+            double dx = v2.x - v1.x;
+            double dy = v2.y - v1.y;
+            double tol = EPS * sqrt(calcSqrSum(dx, dy));
+            double min_x = std::min(v1.x, v2.x) - EPS, max_x = std::max(v1.x, v2.x) + EPS;
+            double min_y = std::min(v1.y, v2.y) - EPS, max_y = std::max(v1.y, v2.y) + EPS;
+            bool upward = v2.y > v1.y;
+            for (size_t i = 0; i < n; ++i) {
+                double px = pts[i].x, py = pts[i].y;
+                double t = dx * (py - v1.y) - (px - v1.x) * dy;  // > 0: point is left of the edge
+                int crosses = (v1.y > py) != (v2.y > py);
+                in[i] ^= crosses & ((t > 0) == upward);
+                on[i] |= (t <= tol) & (t >= -tol) & (px >= min_x) & (px <= max_x) & (py >= min_y) & (py <= max_y);
+            }
+        }
+        std::vector<char> res(n);
+        for (size_t i = 0; i < n; ++i) {
+            res[i] = in[i] | on[i];
         }
         return res;
     }
 
-    bool operator==(const Polygon& rhs) {
-        if (this->vertices.size() != rhs.vertices.size()) {
+    bool operator==(const Polygon& rhs) {  // same vertices in cyclic order, either direction; O(n)
+        size_t vcnt = rhs.vertices.size();
+        if (this->vertices.size() != vcnt) {
             return false;
         }
-        size_t vcnt = rhs.vertices.size();
+        if (vcnt == 0) {
+            return true;
+        }
         size_t j = 0;
-        for (size_t i = 0; i < vcnt; ++i) {
-            if (this->vertices[0] != rhs.vertices[j]) {
-                j += 1;
-            }
+        while ((j < vcnt) and (rhs.vertices[j] != this->vertices[0])) {  // start vertex in rhs
+            ++j;
         }
-        for (size_t i = 0; i < vcnt; ++i) {
-            if ((this->vertices[i] != rhs.vertices[(j + i) % vcnt]) and
-                (this->vertices[i] != rhs.vertices[(j - i + vcnt) % vcnt])) {
-                return false;
-            }
+        if (j == vcnt) {
+            return false;
         }
-        return true;
+        bool forward = true, backward = true;
+        for (size_t i = 1; (i < vcnt) and (forward or backward); ++i) {
+            forward = forward and (this->vertices[i] == rhs.vertices[(j + i) % vcnt]);
+            backward = backward and (this->vertices[i] == rhs.vertices[(j + vcnt - i) % vcnt]);
+        }
+        return forward or backward;
     }
 
     bool operator!=(const Polygon& rhs) {
         return !(*this == rhs);
     }
 
-    void rotate(Point center, double angle) override {
-        for (size_t i = 0; i < this->verticesCount(); ++i) {
-            vertices[i].x -= center.x;
-            vertices[i].y -= center.y;
-        }
-        for (size_t i = 0; i < this->verticesCount(); ++i) {
-            double x1 = rotateX(vertices[i].x, vertices[i].y, angle);
-            double y1 = rotateY(vertices[i].x, vertices[i].y, angle);
-            vertices[i].x = x1;
-            vertices[i].y = y1;
-        }
-        for (size_t i = 0; i < this->verticesCount(); ++i) {
-            vertices[i].x += center.x;
-            vertices[i].x += center.y;
-        }
-    }
-
-    void scale(Point center, double coeff) override {
-        for (size_t i = 0; i < this->verticesCount(); ++i) {
-            vertices[i].x -= center.x;
-            vertices[i].x -= center.y;
-        }
-        for (size_t i = 0; i < this->verticesCount(); ++i) {
-            vertices[i].x *= coeff;
-            vertices[i].y *= coeff;
-        }
-        for (size_t i = 0; i < this->verticesCount(); ++i) {
-            vertices[i].x += center.x;
-            vertices[i].x += center.y;
-        }
-    }
-
-    void reflex(Point center) override {
-        this->scale(center, 1.0);
-    }
-
-    void reflex(Line axis) override {
-        std::vector<double> coeffs = axis.getLineCoeffs();
-        double a = coeffs[0];
-        double b = coeffs[1];
-        double c = coeffs[2];
-        for (size_t i = 0; i < this->verticesCount(); ++i) {
-            double d = a * this->vertices[i].y - b * this->vertices[i].x;
-            double y1 = (b * c - a * d) / calcSqrSum(a, b);
-            double x1 = (a * y1 - d) / b;
-            this->vertices[i].x = 2 * x1 - this->vertices[i].x;
-            this->vertices[i].y = 2 * y1 - this->vertices[i].y;
-        }
+    void transform(const AffineTransform& t) override {
+        t.apply(this->vertices.data(), this->vertices.size());
     }
 
 private:
@@ -208,16 +562,14 @@ private:
 
 class Ellipse: public Shape {
 public:
-    Ellipse(Point f1, Point f2, double a2) : f1(f1), f2(f2), a2(a2) {}
+    Ellipse(Point f1, Point f2, double a2) : f1(f1), f2(f2), a2(a2), params(computeParams(f1, f2, a2)) {}
 
     std::pair<Point, Point> focuses() const {
         return std::make_pair(f1, f2);
     }
 
     double eccentricity() const {
-        double c = calcDistance(this->f1, this->f2) * 0.5;
-        double a = this->a2 * 0.5;
-        return c / a;
+        return this->params.c / (this->a2 * 0.5);
     }
 
     Point center() const {
@@ -230,18 +582,41 @@ public:
     }
 
     double perimeter() const override {
-        double a = this->a2 * 0.5;
-        double c = calcDistance(this->f1, this->f2) * 0.5;
-        double b = sqrt(a * a - c * c);
-        double d = 3 * pow((a - b) / (a + b), 2);
-        return M_PI * (a + b) * (1 + d / (10 + sqrt(4 - d)));  // Ramanujan approx
+        return this->params.perimeter;
     }
 
     double area() const override {
+        return M_PI * this->a2 * 0.5 * this->params.b;
+    }
+
+    BoundingBox boundingBox() const override {  // exact box of the ellipse rotated along its focal axis
         double a = this->a2 * 0.5;
-        double c = calcDistance(this->f1, this->f2) * 0.5;
-        double b = sqrt(a * a - c * c);
-        return M_PI * a * b;
+        double c = this->params.c, b = this->params.b;
+        double cos_t = c > 0 ? (this->f2.x - this->f1.x) * 0.5 / c : 1.0;
+        double sin_t = c > 0 ? (this->f2.y - this->f1.y) * 0.5 / c : 0.0;
+        double dx = sqrt(calcSqrSum(a * cos_t, b * sin_t));
+        double dy = sqrt(calcSqrSum(a * sin_t, b * cos_t));
+        Point o = this->center();
+        return BoundingBox(Point(o.x - dx, o.y - dy), Point(o.x + dx, o.y + dy));
+    }
+
+    bool containsPoint(const Point& p) const override {
+        return calcDistance(p, this->f1) + calcDistance(p, this->f2) <= this->a2 + EPS;
+    }
+
+    std::vector<char> containsPoints(const std::vector<Point>& points) const override {  // focal-distance sums
+        std::vector<char> res(points.size());
+        char* __restrict out = res.data();  // char stores may otherwise alias the coordinates
+        const Point* pts = points.data();
+        size_t n = points.size();
+        const Point f1 = this->f1, f2 = this->f2;
+        double limit = this->a2 + EPS;
+        for (size_t i = 0; i < n; ++i) {
+            double d1 = sqrt(calcSqrSum(pts[i].x - f1.x, pts[i].y - f1.y));
+            double d2 = sqrt(calcSqrSum(pts[i].x - f2.x, pts[i].y - f2.y));
+            out[i] = d1 + d2 <= limit;
+        }
+        return res;
     }
 
     bool operator==(const Ellipse& rhs) {
@@ -260,59 +635,81 @@ public:
         return !(*this == rhs);
     }
 
-    void rotate(Point center, double angle) override {
-        f1.x -= center.x;  // first focus
-        f1.y -= center.y;
-        double x1 = rotateX(f1.x, f1.y, angle);
-        double y1 = rotateY(f1.x, f1.y, angle);
-        f1.x = x1 + center.x;
-        f1.y = y1 + center.y;
-        f2.x -= center.x;  // second focus
-        f2.y -= center.y;
-        x1 = rotateX(f2.x, f2.y, angle);
-        y1 = rotateY(f2.x, f2.y, angle);
-        f2.x = x1 + center.x;
-        f2.y = y1 + center.y;
-    }
-
-    void reflex(Point center) override {
-        this->scale(center, 1.0);
-    }
-
-    void reflex(Line axis) override {
-        std::vector<double> coeffs = axis.getLineCoeffs();
-        double a = coeffs[0];
-        double b = coeffs[1];
-        double c = coeffs[2];
-        double d = a * this->f1.y - b * this->f1.x;  // first focus
-        double y1 = (b * c - a * d) / calcSqrSum(a, b);
-        double x1 = (a * y1 - d) / b;
-        this->f1.x = 2 * x1 - this->f1.x;
-        this->f1.y = 2 * y1 - this->f1.y;
-        d = a * this->f2.y - b * this->f2.x;  // second focus
-        y1 = (b * c - a * d) / calcSqrSum(a, b);
-        x1 = (y1 * a - d) / b;
-        this->f2.x = 2 * x1 - this->f2.x;
-        this->f2.y = 2 * y1 - this->f2.y;
-    }
-
-    void scale(Point center, double coeff) override {
-        this->f1.x = coeff * (this->f1.x - center.x) + center.x;
-        this->f1.y = coeff * (this->f1.y - center.y) + center.y;
-        this->f2.x = coeff * (this->f2.x - center.x) + center.x;
-        this->f2.y = coeff * (this->f2.y - center.y) + center.y;
-        this->a2 *= coeff;
+    void transform(const AffineTransform& t) override {
+        double k = t.scaleFactor();
+        this->f1 = t.apply(this->f1);
+        this->f2 = t.apply(this->f2);
+        this->a2 *= k;
+        this->params.c *= k;  // a similarity scales every length, so no recomputation is needed
+        this->params.b *= k;
+        this->params.perimeter *= k;
     }
 
 private:
+    struct Derived {
+        double c;  // half the focal distance
+        double b;  // semi-minor axis
+        double perimeter;
+    };
+
     Point f1, f2;  // f1, f2: ellipse focuses
     double a2;  // a2 = 2 * a: ellipse width
+    Derived params;  // computed on construction and scaled by transform(), so const methods only read
+
+    static Derived computeParams(const Point& f1, const Point& f2, double a2) {
+        double a = a2 * 0.5;
+        double c = calcDistance(f1, f2) * 0.5;
+        double b = sqrt(a * a - c * c);
+        double d = 3 * pow((a - b) / (a + b), 2);
+        return Derived{c, b, M_PI * (a + b) * (1 + d / (10 + sqrt(4 - d)))};  // Ramanujan approx
+    }
 };
 
 
+void transformShapes(const std::vector<Shape*>& shapes, const AffineTransform& t) {  // one combined matrix per shape
+    for (auto shape : shapes) {
+        shape->transform(t);
+    }
+}
+
+
 class Circle: public Ellipse {
 public:
     Circle(Point center, double radius) : Ellipse(center, center, radius * 2) {}
+
+    double perimeter() const override {  // c = 0: no focal distance or Ramanujan series needed
+        return 2 * M_PI * this->radius();
+    }
+
+    double area() const override {
+        double r = this->radius();
+        return M_PI * r * r;
+    }
+
+    BoundingBox boundingBox() const override {
+        Point o = this->center();
+        double r = this->radius();
+        return BoundingBox(Point(o.x - r, o.y - r), Point(o.x + r, o.y + r));
+    }
+
+    bool containsPoint(const Point& p) const override {
+        Point o = this->center();
+        double r = this->radius() + EPS;
+        return calcSqrSum(p.x - o.x, p.y - o.y) <= r * r;
+    }
+
+    std::vector<char> containsPoints(const std::vector<Point>& points) const override {  // no sqrt per point
+        std::vector<char> res(points.size());
+        char* __restrict out = res.data();
+        const Point* pts = points.data();
+        size_t n = points.size();
+        Point o = this->center();
+        double r = this->radius() + EPS;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = calcSqrSum(pts[i].x - o.x, pts[i].y - o.y) <= r * r;
+        }
+        return res;
+    }
 };
 
 
@@ -320,28 +717,66 @@ class Rectangle: public Polygon {
 public:
     Rectangle(Point p1, Point p3, double coeff) : Polygon(initPoints(p1, p3, coeff)) {}
 
-    Point center() {
-        auto vertices = this->getVertices();
+    explicit Rectangle(std::vector<Point> vertices) : Polygon(std::move(vertices)) {}  // four corners in order, unchecked
+
+    Point center() const {
+        const auto& vertices = this->getVertices();
         Point res((vertices[0].x + vertices[2].x) * 0.5, (vertices[0].y + vertices[2].y) * 0.5);
         return res;
     }
 
-    std::pair<Line, Line> diagonals() {
-        auto vertices = this->getVertices();
+    std::pair<Line, Line> diagonals() const {
+        const auto& vertices = this->getVertices();
         Line diag1 = Line(vertices[0], vertices[2]);
         Line diag2 = Line(vertices[1], vertices[3]);
         return std::make_pair(diag1, diag2);
     }
 
+    bool containsPoint(const Point& p) const override {
+        return SideProjections(this->getVertices()).contains(p);
+    }
+
+    std::vector<char> containsPoints(const std::vector<Point>& points) const override {
+        SideProjections test(this->getVertices());
+        std::vector<char> res(points.size());
+        char* __restrict out = res.data();
+        const Point* pts = points.data();
+        size_t n = points.size();
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = test.contains(pts[i]);
+        }
+        return res;
+    }
+
 private:
+    struct SideProjections {  // point is inside iff its projections on two adjacent sides fall within them
+        explicit SideProjections(const std::vector<Point>& vertices) : o(vertices[0]) {
+            ux = vertices[1].x - o.x, uy = vertices[1].y - o.y;
+            vx = vertices[3].x - o.x, vy = vertices[3].y - o.y;
+            u_len = calcSqrSum(ux, uy), v_len = calcSqrSum(vx, vy);
+            u_tol = EPS * sqrt(u_len), v_tol = EPS * sqrt(v_len);
+        }
+
+        bool contains(const Point& p) const {  // branch-free, vectorizes in loops
+            double px = p.x - o.x, py = p.y - o.y;
+            double du = px * ux + py * uy;
+            double dv = px * vx + py * vy;
+            return (du >= -u_tol) & (du <= u_len + u_tol) & (dv >= -v_tol) & (dv <= v_len + v_tol);
+        }
+
+        Point o;
+        double ux, uy, vx, vy;
+        double u_len, v_len, u_tol, v_tol;
+    };
+
     static std::vector<Point> initPoints(Point p1, Point p3, double coeff) {
         if (coeff < 1) {
             coeff = 1 / coeff;
         }
-        double angle = atan(coeff);
         double x3 = p3.x - p1.x;
         double y3 = p3.y - p1.y;
-        double k = (coeff * coeff + 1);
+        double k = sqrt(coeff * coeff + 1);  // short side = diagonal * cos(angle)
+        Rotation angle{1 / k, coeff / k};  // atan(coeff) without calling atan, cos and sin
         double x2 = rotateX(x3, y3, angle) / k + p1.x;
         double y2 = rotateY(x3, y3, angle) / k + p1.y;
         Point p2(x2, y2);
@@ -356,6 +791,8 @@ class Square: public Rectangle {
 public:
     Square(Point p1, Point p3) : Rectangle(p1, p3, 1) {}
 
+    explicit Square(std::vector<Point> vertices) : Rectangle(std::move(vertices)) {}
+
     Circle circumscribedCircle() {
         double radius = sqrt(2) * this->perimeter() * 0.25;
         Circle res(this->center(), radius);
@@ -369,69 +806,123 @@ public:
 };
 
 
+struct TriangleCenters {
+    Point circumcenter;
+    double circumradius;
+    Point incenter;
+    double inradius;
+    Point centroid;
+    Point orthocenter;
+    Point nine_point_center;  // midpoint of the circumcenter and the orthocenter
+    double nine_point_radius;  // half the circumradius
+};
+
+
+// One pass over shared intermediates: edge vectors from a, their squared lengths and one cross product.
+TriangleCenters triangleCenters(const Point& a, const Point& b, const Point& c) {
+    double bx = b.x - a.x, by = b.y - a.y;
+    double cx = c.x - a.x, cy = c.y - a.y;
+    double sqr_b = calcSqrSum(bx, by), sqr_c = calcSqrSum(cx, cy);
+    double k = 2 * (bx * cy - by * cx);  // four times the signed area
+    double ox = (cy * sqr_b - by * sqr_c) / k;  // circumcenter relative to a
+    double oy = (bx * sqr_c - cx * sqr_b) / k;
+    double side_a = sqrt(calcSqrSum(c.x - b.x, c.y - b.y)), side_b = sqrt(sqr_c), side_c = sqrt(sqr_b);
+    double p = side_a + side_b + side_c;
+    TriangleCenters res;
+    res.circumcenter = Point(a.x + ox, a.y + oy);
+    res.circumradius = sqrt(calcSqrSum(ox, oy));
+    res.incenter = Point((side_a * a.x + side_b * b.x + side_c * c.x) / p,
+                         (side_a * a.y + side_b * b.y + side_c * c.y) / p);
+    res.inradius = std::abs(k) * 0.5 / p;  // area / semiperimeter
+    res.centroid = Point((a.x + b.x + c.x) / 3, (a.y + b.y + c.y) / 3);
+    res.orthocenter = Point(a.x + b.x + c.x - 2 * res.circumcenter.x, a.y + b.y + c.y - 2 * res.circumcenter.y);
+    res.nine_point_center = Point(a.x + (bx + cx - ox) * 0.5, a.y + (by + cy - oy) * 0.5);  // (O + H) / 2
+    res.nine_point_radius = res.circumradius * 0.5;
+    return res;
+}
+
+
 class Triangle: public Polygon {
 public:
-    Triangle(Point& p1, Point& p2, Point& p3) : Polygon({p1, p2, p3}) {}
+    Triangle(const Point& p1, const Point& p2, const Point& p3) : Polygon({p1, p2, p3}) {}
 
-    Circle circumscribedCircle() {
-        auto vertices = this->getVertices();
-        Point v1(vertices[0].x, vertices[0].y);
-        Point v2(vertices[1].x - v1.x, vertices[1].y - v1.y);
-        Point v3(vertices[2].x - v1.x, vertices[2].y - v1.y);
-        double k = 2 * (v2.x * v3.y - v2.y * v3.x);
-        double x = (v3.y * calcSqrSum(v2.x, v2.y) - v2.y * calcSqrSum(v3.x, v3.y)) / k;
-        double y = (v2.x * calcSqrSum(v3.x, v3.y) - v3.x * calcSqrSum(v2.x, v2.y)) / k;
-        double radius = sqrt(calcSqrSum(x, y));
-        Point center(x + v1.x, y + v1.y);
-        Circle res(center, radius);
-        return res;
+    bool containsPoint(const Point& p) const override {
+        return EdgeSigns(this->getVertices()).contains(p);
     }
 
-    Circle inscribedCircle() {
-        auto vertices = this->getVertices();
-        double a = calcDistance(vertices[1], vertices[2]);
-        double b = calcDistance(vertices[0], vertices[2]);
-        double c = calcDistance(vertices[0], vertices[1]);
-        double p = a + b + c;
-        double x = (a * vertices[0].x + b * vertices[1].x + c * vertices[2].x) / p;
-        double y = (a * vertices[0].y + b * vertices[1].y + c * vertices[2].y) / p;
-        double radius = sqrt((p * 0.5 - a) * (p * 0.5 - b) * (p * 0.5 - c) / (p * 0.5));
-        Point center(x, y);
-        Circle res(center, radius);
+    std::vector<char> containsPoints(const std::vector<Point>& points) const override {
+        EdgeSigns test(this->getVertices());
+        std::vector<char> res(points.size());
+        char* __restrict out = res.data();
+        const Point* pts = points.data();
+        size_t n = points.size();
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = test.contains(pts[i]);
+        }
         return res;
     }
 
-    Point centroid() {
-        auto vertices = this->getVertices();
-        Point v1 = vertices[0];
-        Point v2 = vertices[1];
-        Point v3 = vertices[2];
-        Point res((v1.x + v2.x + v3.x) / 3, (v1.y + v2.y + v3.y) / 3);
-        return res;
+    bool isDegenerate() const {  // exactly collinear vertices
+        const auto& vertices = this->getVertices();
+        return ::orientation(vertices[0], vertices[1], vertices[2]) == 0;
     }
 
-    Point orthocenter() {
-        Point cs_center = this->circumscribedCircle().center();
-        Point res = cs_center;
-        auto vertices = this->getVertices();
-        for (size_t i = 0; i < 3; ++i) {
-            res.x += (vertices[i].x - cs_center.x);
-            res.y += (vertices[i].y - cs_center.y);
-        }
-        return res;
+    int inCircumscribedCircle(const Point& p) const {  // exact: 1 inside, 0 on the circle, -1 outside
+        const auto& v = this->getVertices();
+        double det = inCircle(v[0], v[1], v[2], p), turn = ::orientation(v[0], v[1], v[2]);
+        return ((det > 0) - (det < 0)) * ((turn > 0) - (turn < 0));
     }
 
-    Line EulerLine() {
-        Line res(this->orthocenter(), this->centroid());
-        return res;
+    TriangleCenters centers() const {  // all centers at once, cheaper than calling the methods below one by one
+        const auto& v = this->getVertices();
+        return triangleCenters(v[0], v[1], v[2]);
     }
 
-    Circle ninePointsCircle() {
-        Point orthocenter = this->orthocenter();
-        Point cs_center = this->circumscribedCircle().center();
-        Point center((orthocenter.x + cs_center.x) * 0.5, (orthocenter.y + cs_center.y) * 0.5);
-        double radius = this->circumscribedCircle().radius() * 0.5;
-        Circle res(center, radius);
-        return res;
+    Circle circumscribedCircle() const {
+        TriangleCenters c = this->centers();
+        return Circle(c.circumcenter, c.circumradius);
     }
+
+    Circle inscribedCircle() const {
+        TriangleCenters c = this->centers();
+        return Circle(c.incenter, c.inradius);
+    }
+
+    Point centroid() const {
+        const auto& v = this->getVertices();
+        return Point((v[0].x + v[1].x + v[2].x) / 3, (v[0].y + v[1].y + v[2].y) / 3);
+    }
+
+    Point orthocenter() const {
+        return this->centers().orthocenter;
+    }
+
+    Line EulerLine() const {
+        TriangleCenters c = this->centers();
+        return Line(c.orthocenter, c.centroid);
+    }
+
+    Circle ninePointsCircle() const {
+        TriangleCenters c = this->centers();
+        return Circle(c.nine_point_center, c.nine_point_radius);
+    }
+
+private:
+    struct EdgeSigns {  // point is inside iff it is not strictly on opposite sides of two edges
+        explicit EdgeSigns(const std::vector<Point>& vertices) : a(vertices[0]), b(vertices[1]), c(vertices[2]) {
+            tol_ab = EPS * calcDistance(a, b), tol_bc = EPS * calcDistance(b, c), tol_ca = EPS * calcDistance(c, a);
+        }
+
+        bool contains(const Point& p) const {  // branch-free, vectorizes in loops
+            double d1 = (b.x - a.x) * (p.y - a.y) - (p.x - a.x) * (b.y - a.y);
+            double d2 = (c.x - b.x) * (p.y - b.y) - (p.x - b.x) * (c.y - b.y);
+            double d3 = (a.x - c.x) * (p.y - c.y) - (p.x - c.x) * (a.y - c.y);
+            bool has_neg = (d1 < -tol_ab) | (d2 < -tol_bc) | (d3 < -tol_ca);
+            bool has_pos = (d1 > tol_ab) | (d2 > tol_bc) | (d3 > tol_ca);
+            return !(has_neg & has_pos);
+        }
+
+        Point a, b, c;
+        double tol_ab, tol_bc, tol_ca;
+    };
 };
\ No newline at end of file
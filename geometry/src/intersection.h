@@ -0,0 +1,332 @@
+#pragma once
+
+#include <vector>
+#include <map>
+#include <set>
+#include <limits>
+#include <optional>
+#include <algorithm>
+#include <cmath>
+
+#include "geometry.h"
+
+
+struct Segment {  // closed segment between two points
+    Point a;
+    Point b;
+
+    Segment(const Point& a, const Point& b) : a(a), b(b) {}
+
+    BoundingBox boundingBox() const {
+        return BoundingBox(Point(std::min(this->a.x, this->b.x), std::min(this->a.y, this->b.y)),
+                           Point(std::max(this->a.x, this->b.x), std::max(this->a.y, this->b.y)));
+    }
+
+    bool intersects(const Segment& rhs) const {  // touching at an endpoint counts
+        double d1 = orientation(this->a, this->b, rhs.a), d2 = orientation(this->a, this->b, rhs.b);
+        double d3 = orientation(rhs.a, rhs.b, this->a), d4 = orientation(rhs.a, rhs.b, this->b);
+        if ((((d1 > 0) and (d2 < 0)) or ((d1 < 0) and (d2 > 0))) and (((d3 > 0) and (d4 < 0)) or ((d3 < 0) and (d4 > 0)))) {
+            return true;
+        }
+        return ((d1 == 0) and this->boundingBox().contains(rhs.a)) or ((d2 == 0) and this->boundingBox().contains(rhs.b)) or
+               ((d3 == 0) and rhs.boundingBox().contains(this->a)) or ((d4 == 0) and rhs.boundingBox().contains(this->b));
+    }
+
+    // common point of the segments; for overlapping collinear segments one of the endpoints inside the overlap
+    std::optional<Point> intersection(const Segment& rhs) const {
+        if (!this->intersects(rhs)) {
+            return std::nullopt;
+        }
+        double dx = this->b.x - this->a.x, dy = this->b.y - this->a.y;
+        double ex = rhs.b.x - rhs.a.x, ey = rhs.b.y - rhs.a.y;
+        double denom = dx * ey - dy * ex;
+        if (denom == 0) {
+            for (const Point& p : {rhs.a, rhs.b}) {
+                if (this->boundingBox().contains(p)) {
+                    return p;
+                }
+            }
+            return this->a;
+        }
+        double t = ((rhs.a.x - this->a.x) * ey - (rhs.a.y - this->a.y) * ex) / denom;
+        t = std::max(0.0, std::min(1.0, t));
+        return Point(this->a.x + t * dx, this->a.y + t * dy);
+    }
+
+    std::optional<Point> intersection(const Line& line) const {  // nullopt also when the segment lies on the line
+        LineCoeffs coeffs = line.coeffs();
+        double s1 = coeffs.a * this->a.x + coeffs.b * this->a.y + coeffs.c;
+        double s2 = coeffs.a * this->b.x + coeffs.b * this->b.y + coeffs.c;
+        if (((s1 > 0) and (s2 > 0)) or ((s1 < 0) and (s2 < 0)) or ((s1 == 0) and (s2 == 0))) {
+            return std::nullopt;
+        }
+        double t = s1 / (s1 - s2);
+        return Point(this->a.x + t * (this->b.x - this->a.x), this->a.y + t * (this->b.y - this->a.y));
+    }
+};
+
+
+std::vector<Segment> polygonEdges(const Polygon& polygon) {
+    const auto& vertices = polygon.getVertices();
+    std::vector<Segment> res;
+    res.reserve(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        res.emplace_back(vertices[i], vertices[(i + 1) % vertices.size()]);
+    }
+    return res;
+}
+
+
+// Bentley-Ottmann sweep from left to right: all pairs (i < j) of intersecting segments in O((n + k) log n).
+// The status keeps segments ordered by y at the sweep line; only neighbours in it are tested, and crossings
+// found to the right of the sweep become events that swap the pair. Segments meeting at an event point are
+// collected from the status and paired there, so shared polygon vertices are reported as well.
+class SegmentSweep {
+public:
+    explicit SegmentSweep(const std::vector<Segment>& segments) : status(StatusLess{this}) {
+        this->segments.reserve(segments.size());
+        for (const auto& segment : segments) {  // left endpoint first
+            bool forward = !lexicographicLess(segment.b, segment.a);
+            this->segments.emplace_back(forward ? segment.a : segment.b, forward ? segment.b : segment.a);
+        }
+        this->positions.resize(segments.size());
+        this->active.assign(segments.size(), 0);
+    }
+
+    std::vector<std::pair<size_t, size_t>> intersectingPairs() {
+        for (size_t i = 0; i < this->segments.size(); ++i) {
+            this->events[this->segments[i].a].starting.push_back(i);
+            this->events[this->segments[i].b].ending.push_back(i);
+        }
+        while (!this->events.empty()) {
+            auto it = this->events.begin();
+            this->sweep = it->first;
+            Event event = std::move(it->second);
+            this->events.erase(it);
+            this->handle(event);
+        }
+        std::sort(this->pairs.begin(), this->pairs.end());
+        this->pairs.erase(std::unique(this->pairs.begin(), this->pairs.end()), this->pairs.end());
+        return this->pairs;
+    }
+
+private:
+    struct Event {
+        std::vector<size_t> starting;
+        std::vector<size_t> ending;
+        std::vector<size_t> crossing;
+    };
+
+    struct StatusLess {  // order just to the right of the current event point; index n is a probe at that point
+        const SegmentSweep* sweep;
+
+        bool operator()(size_t lhs, size_t rhs) const {
+            double ly = this->sweep->yAt(lhs), ry = this->sweep->yAt(rhs);
+            if (std::abs(ly - ry) > this->sweep->tolerance()) {
+                return ly < ry;
+            }
+            double ls = this->sweep->slope(lhs), rs = this->sweep->slope(rhs);
+            return (ls != rs) ? (ls < rs) : (lhs < rhs);
+        }
+    };
+
+    typedef std::set<size_t, StatusLess> Status;
+
+    double tolerance() const {
+        return EPS * (1 + std::abs(this->sweep.x) + std::abs(this->sweep.y));
+    }
+
+    double yAt(size_t i) const {
+        if (i == this->segments.size()) {
+            return this->sweep.y;
+        }
+        const Segment& s = this->segments[i];
+        if (s.a.x == s.b.x) {  // vertical segments are met at the event point within them
+            return std::max(s.a.y, std::min(this->sweep.y, s.b.y));
+        }
+        if (this->sweep.x == s.a.x) {
+            return s.a.y;
+        }
+        if (this->sweep.x == s.b.x) {
+            return s.b.y;
+        }
+        return s.a.y + (this->sweep.x - s.a.x) * (s.b.y - s.a.y) / (s.b.x - s.a.x);
+    }
+
+    double slope(size_t i) const {
+        if (i == this->segments.size()) {
+            return -std::numeric_limits<double>::infinity();
+        }
+        const Segment& s = this->segments[i];
+        return (s.a.x == s.b.x) ? std::numeric_limits<double>::infinity() : (s.b.y - s.a.y) / (s.b.x - s.a.x);
+    }
+
+    void report(size_t i, size_t j) {
+        if (this->segments[i].intersects(this->segments[j])) {
+            this->pairs.emplace_back(std::min(i, j), std::max(i, j));
+        }
+    }
+
+    void check(size_t below, size_t above) {  // newly adjacent pair
+        std::optional<Point> p = this->segments[below].intersection(this->segments[above]);
+        if (!p) {
+            return;
+        }
+        this->pairs.emplace_back(std::min(below, above), std::max(below, above));
+        if (lexicographicLess(this->sweep, *p)) {
+            auto& crossing = this->events[*p].crossing;
+            crossing.push_back(below);
+            crossing.push_back(above);
+        }
+    }
+
+    void handle(const Event& event) {
+        std::vector<size_t> through = event.crossing;  // active segments passing through the event point
+        through.insert(through.end(), event.ending.begin(), event.ending.end());
+        size_t probe = this->segments.size();
+        auto first = this->status.lower_bound(probe);
+        for (auto it = first; (it != this->status.end()) and
+                              (std::abs(this->yAt(*it) - this->sweep.y) <= this->tolerance()); ++it) {
+            through.push_back(*it);
+        }
+        for (auto it = first; (it != this->status.begin()) and
+                              (std::abs(this->yAt(*std::prev(it)) - this->sweep.y) <= this->tolerance()); --it) {
+            through.push_back(*std::prev(it));
+        }
+        std::sort(through.begin(), through.end());
+        through.erase(std::unique(through.begin(), through.end()), through.end());
+        through.erase(std::remove_if(through.begin(), through.end(), [this](size_t i) { return !this->active[i]; }),
+                      through.end());
+
+        std::vector<size_t> meeting(through);
+        meeting.insert(meeting.end(), event.starting.begin(), event.starting.end());
+        for (size_t i = 0; i < meeting.size(); ++i) {
+            for (size_t j = i + 1; j < meeting.size(); ++j) {
+                this->report(meeting[i], meeting[j]);
+            }
+        }
+
+        for (size_t i : through) {
+            this->status.erase(this->positions[i]);
+            this->active[i] = 0;
+        }
+        std::vector<size_t> inserted;
+        for (size_t i : meeting) {  // segments continuing to the right, reordered for it
+            if (lexicographicLess(this->sweep, this->segments[i].b)) {
+                this->positions[i] = this->status.insert(i).first;
+                this->active[i] = 1;
+                inserted.push_back(i);
+            }
+        }
+
+        if (inserted.empty()) {
+            auto above = this->status.lower_bound(probe);
+            if ((above != this->status.begin()) and (above != this->status.end())) {
+                this->check(*std::prev(above), *above);
+            }
+            return;
+        }
+        auto lowest = this->positions[inserted[0]], highest = lowest;
+        for (size_t i : inserted) {
+            if (this->status.key_comp()(i, *lowest)) {
+                lowest = this->positions[i];
+            }
+            if (this->status.key_comp()(*highest, i)) {
+                highest = this->positions[i];
+            }
+        }
+        if (lowest != this->status.begin()) {
+            this->check(*std::prev(lowest), *lowest);
+        }
+        if (std::next(highest) != this->status.end()) {
+            this->check(*highest, *std::next(highest));
+        }
+    }
+
+    std::vector<Segment> segments;
+    std::vector<Status::iterator> positions;
+    std::vector<char> active;
+    std::map<Point, Event, LexicographicLess> events;
+    Status status;
+    Point sweep;
+    std::vector<std::pair<size_t, size_t>> pairs;
+};
+
+
+std::vector<std::pair<size_t, size_t>> intersectingPairs(const std::vector<Segment>& segments) {
+    return SegmentSweep(segments).intersectingPairs();
+}
+
+
+bool isSimple(const Polygon& polygon) {  // no edges meet except neighbours at their shared vertex
+    size_t n = polygon.verticesCount();
+    for (const auto& [i, j] : intersectingPairs(polygonEdges(polygon))) {
+        if ((j != i + 1) and !((i == 0) and (j == n - 1))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+const size_t kBruteForceEdgePairs = 1 << 22;  // measured crossover with the sweep in bench/bench.cpp
+
+// Shared area or touching boundaries. Bounding boxes are compared first; small polygons test edge pairs directly,
+// large ones run the sweep over both edge sets.
+bool polygonsIntersect(const Polygon& lhs, const Polygon& rhs) {
+    if (!lhs.boundingBox().intersects(rhs.boundingBox()) or (lhs.verticesCount() == 0) or (rhs.verticesCount() == 0)) {
+        return false;
+    }
+    if (lhs.containsPoint(rhs.getVertices()[0]) or rhs.containsPoint(lhs.getVertices()[0])) {
+        return true;
+    }
+    std::vector<Segment> edges = polygonEdges(lhs);
+    std::vector<Segment> other = polygonEdges(rhs);
+    if (edges.size() * other.size() <= kBruteForceEdgePairs) {
+        for (const auto& e : edges) {
+            BoundingBox box = e.boundingBox();
+            for (const auto& f : other) {
+                if (box.intersects(f.boundingBox()) and e.intersects(f)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+    size_t split = edges.size();
+    edges.insert(edges.end(), other.begin(), other.end());
+    for (const auto& [i, j] : intersectingPairs(edges)) {
+        if ((i < split) and (j >= split)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// Sutherland-Hodgman: the part of subject inside a convex clip polygon (either orientation).
+// Disjoint polygons give a polygon without vertices.
+Polygon clipPolygon(const Polygon& subject, const Polygon& clip) {
+    std::vector<Point> res = subject.getVertices();
+    const auto& window = clip.getVertices();
+    double sign = polygonOrientation(window) < 0 ? -1 : 1;
+    for (size_t e = 0; (e < window.size()) and !res.empty(); ++e) {
+        const Point& a = window[e];
+        const Point& b = window[(e + 1) % window.size()];
+        std::vector<Point> input;
+        input.swap(res);
+        for (size_t i = 0; i < input.size(); ++i) {
+            const Point& p = input[i];
+            const Point& q = input[(i + 1) % input.size()];
+            double sp = sign * cross(a, b, p), sq = sign * cross(a, b, q);
+            if (sp >= 0) {
+                res.push_back(p);
+            }
+            if (((sp > 0) and (sq < 0)) or ((sp < 0) and (sq > 0))) {
+                double t = sp / (sp - sq);
+                res.emplace_back(p.x + t * (q.x - p.x), p.y + t * (q.y - p.y));
+            }
+        }
+    }
+    return Polygon(res);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+
+size_t hardwareThreads() {  // cached: std::thread::hardware_concurrency reads /proc on every call
+    static const size_t threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    return threads;
+}
+
+
+// Calls func(begin, end) over consecutive ranges of [0, count), one range per thread; ranges are never shorter
+// than min_chunk, so small inputs run on the calling thread only.
+template <class Func>
+void parallelChunks(size_t count, size_t min_chunk, Func func) {
+    size_t chunks = std::min(hardwareThreads(), count / std::max<size_t>(min_chunk, 1));
+    if (chunks < 2) {
+        func(size_t(0), count);
+        return;
+    }
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < chunks; ++i) {
+        threads.emplace_back(func, count * i / chunks, count * (i + 1) / chunks);
+    }
+    func(size_t(0), count / chunks);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+
+// Calls func(begin, end) for every block [k * block, (k + 1) * block) of [0, count), the last one shorter. Threads
+// take the next free block from a shared counter, so blocks of uneven cost balance out; which thread ran a block
+// never matters to callers that keep one result per block.
+template <class Func>
+void parallelBlocks(size_t count, size_t block, Func func) {
+    block = std::max<size_t>(block, 1);
+    size_t blocks = (count + block - 1) / block;
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t k = next++; k < blocks; k = next++) {
+            func(k * block, std::min(count, (k + 1) * block));
+        }
+    };
+    size_t workers = std::min(hardwareThreads(), blocks);
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < workers; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
@@ -0,0 +1,407 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <limits>
+#include <utility>
+#include <optional>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+#include "geometry.h"
+#include "parallel.h"
+
+
+// Spatial queries over point sets. Both indexes copy the points and answer with indices into the input vector;
+// all comparisons use squared distances, so no query calls sqrt.
+
+const size_t kNoPoint = std::numeric_limits<size_t>::max();  // answer of a nearest query on an empty index
+const size_t kKdLeafSize = 16;
+const size_t kParallelQueryChunk = 1 << 10;  // batched queries and builds run on one thread below this many points
+
+
+double sqrDistance(const Point& p1, const Point& p2) {
+    return calcSqrSum(p1.x - p2.x, p1.y - p2.y);
+}
+
+
+class PointKdTree {  // implicit k-d tree: the median of every range splits it, leaves are ranges of kKdLeafSize points
+public:
+    PointKdTree() = default;
+
+    explicit PointKdTree(const std::vector<Point>& points) : entries(points.size()), axes(points.size()) {
+        for (size_t i = 0; i < points.size(); ++i) {
+            this->entries[i] = {points[i], i};
+        }
+        size_t parallel_depth = 0;  // the top levels build their halves on separate threads
+        while ((size_t(1) << parallel_depth) < hardwareThreads()) {
+            ++parallel_depth;
+        }
+        this->build(0, this->entries.size(), parallel_depth);
+    }
+
+    size_t size() const {
+        return this->entries.size();
+    }
+
+    size_t nearest(const Point& p) const {  // kNoPoint if empty
+        double best_sqr = INFINITY;
+        size_t best = kNoPoint;
+        this->searchNearest(0, this->entries.size(), p, kNoPoint, best_sqr, best);
+        return best;
+    }
+
+    std::vector<size_t> nearest(const Point& p, size_t k) const {  // k closest, nearest first
+        std::priority_queue<std::pair<double, size_t>> heap;  // max-heap of the k best so far
+        if (k > 0) {
+            this->searchNearest(0, this->entries.size(), p, k, heap);
+        }
+        std::vector<size_t> res(heap.size());
+        for (size_t i = res.size(); i > 0; --i) {
+            res[i - 1] = heap.top().second;
+            heap.pop();
+        }
+        return res;
+    }
+
+    std::vector<size_t> nearest(const std::vector<Point>& queries) const {  // batched, in parallel
+        std::vector<size_t> res(queries.size());
+        parallelChunks(queries.size(), kParallelQueryChunk, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                res[i] = this->nearest(queries[i]);
+            }
+        });
+        return res;
+    }
+
+    std::vector<size_t> radiusSearch(const Point& p, double radius) const {  // points within radius, boundary included
+        std::vector<size_t> res;
+        this->searchRadius(0, this->entries.size(), p, radius * radius, res);
+        return res;
+    }
+
+    std::vector<std::vector<size_t>> radiusSearch(const std::vector<Point>& queries, double radius) const {
+        std::vector<std::vector<size_t>> res(queries.size());
+        parallelChunks(queries.size(), kParallelQueryChunk, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                this->searchRadius(0, this->entries.size(), queries[i], radius * radius, res[i]);
+            }
+        });
+        return res;
+    }
+
+    // For every indexed point the nearest other one (duplicates are each other's neighbors); kNoPoint if alone.
+    std::vector<size_t> allNearestNeighbors() const {
+        std::vector<size_t> res(this->entries.size());
+        parallelChunks(this->entries.size(), kParallelQueryChunk, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {  // tree order, so consecutive queries walk the same nodes
+                double best_sqr = INFINITY;
+                size_t best = kNoPoint;
+                this->searchNearest(0, this->entries.size(), this->entries[i].point, this->entries[i].id, best_sqr, best);
+                res[this->entries[i].id] = best;
+            }
+        });
+        return res;
+    }
+
+private:
+    struct Entry {
+        Point point;
+        size_t id;
+    };
+
+    std::vector<Entry> entries;
+    std::vector<unsigned char> axes;  // split axis of the node whose median sits at this position, 0 is x
+
+    static double coordinate(const Point& p, unsigned char axis) {
+        return axis == 0 ? p.x : p.y;
+    }
+
+    void build(size_t begin, size_t end, size_t parallel_depth) {
+        if (end - begin <= kKdLeafSize) {
+            return;
+        }
+        BoundingBox box;
+        for (size_t i = begin; i < end; ++i) {
+            box.extend(this->entries[i].point);
+        }
+        unsigned char axis = (box.max.x - box.min.x >= box.max.y - box.min.y) ? 0 : 1;
+        size_t mid = begin + (end - begin) / 2;
+        std::nth_element(this->entries.begin() + begin, this->entries.begin() + mid, this->entries.begin() + end,
+                         [axis](const Entry& a, const Entry& b) {
+                             return coordinate(a.point, axis) < coordinate(b.point, axis);
+                         });
+        this->axes[mid] = axis;
+        if ((parallel_depth > 0) and (end - begin >= kParallelQueryChunk)) {
+            std::thread left([=]() { this->build(begin, mid, parallel_depth - 1); });
+            this->build(mid + 1, end, parallel_depth - 1);
+            left.join();
+        } else {
+            this->build(begin, mid, 0);
+            this->build(mid + 1, end, 0);
+        }
+    }
+
+    void searchNearest(size_t begin, size_t end, const Point& p, size_t excluded, double& best_sqr, size_t& best) const {
+        if (end - begin <= kKdLeafSize) {
+            for (size_t i = begin; i < end; ++i) {
+                double d = sqrDistance(p, this->entries[i].point);
+                if ((d < best_sqr) and (this->entries[i].id != excluded)) {
+                    best_sqr = d;
+                    best = this->entries[i].id;
+                }
+            }
+            return;
+        }
+        size_t mid = begin + (end - begin) / 2;
+        const Entry& median = this->entries[mid];
+        double d = sqrDistance(p, median.point);
+        if ((d < best_sqr) and (median.id != excluded)) {
+            best_sqr = d;
+            best = median.id;
+        }
+        double diff = coordinate(p, this->axes[mid]) - coordinate(median.point, this->axes[mid]);
+        if (diff < 0) {
+            this->searchNearest(begin, mid, p, excluded, best_sqr, best);
+            if (diff * diff < best_sqr) {
+                this->searchNearest(mid + 1, end, p, excluded, best_sqr, best);
+            }
+        } else {
+            this->searchNearest(mid + 1, end, p, excluded, best_sqr, best);
+            if (diff * diff < best_sqr) {
+                this->searchNearest(begin, mid, p, excluded, best_sqr, best);
+            }
+        }
+    }
+
+    void offer(const Entry& entry, const Point& p, size_t k, std::priority_queue<std::pair<double, size_t>>& heap) const {
+        double d = sqrDistance(p, entry.point);
+        if (heap.size() < k) {
+            heap.push({d, entry.id});
+        } else if (d < heap.top().first) {
+            heap.pop();
+            heap.push({d, entry.id});
+        }
+    }
+
+    void searchNearest(size_t begin, size_t end, const Point& p, size_t k,
+                       std::priority_queue<std::pair<double, size_t>>& heap) const {
+        if (end - begin <= kKdLeafSize) {
+            for (size_t i = begin; i < end; ++i) {
+                this->offer(this->entries[i], p, k, heap);
+            }
+            return;
+        }
+        size_t mid = begin + (end - begin) / 2;
+        this->offer(this->entries[mid], p, k, heap);
+        double diff = coordinate(p, this->axes[mid]) - coordinate(this->entries[mid].point, this->axes[mid]);
+        size_t near_begin = diff < 0 ? begin : mid + 1, near_end = diff < 0 ? mid : end;
+        size_t far_begin = diff < 0 ? mid + 1 : begin, far_end = diff < 0 ? end : mid;
+        this->searchNearest(near_begin, near_end, p, k, heap);
+        if ((heap.size() < k) or (diff * diff < heap.top().first)) {
+            this->searchNearest(far_begin, far_end, p, k, heap);
+        }
+    }
+
+    void searchRadius(size_t begin, size_t end, const Point& p, double sqr_radius, std::vector<size_t>& res) const {
+        if (end - begin <= kKdLeafSize) {
+            for (size_t i = begin; i < end; ++i) {
+                if (sqrDistance(p, this->entries[i].point) <= sqr_radius) {
+                    res.push_back(this->entries[i].id);
+                }
+            }
+            return;
+        }
+        size_t mid = begin + (end - begin) / 2;
+        if (sqrDistance(p, this->entries[mid].point) <= sqr_radius) {
+            res.push_back(this->entries[mid].id);
+        }
+        double diff = coordinate(p, this->axes[mid]) - coordinate(this->entries[mid].point, this->axes[mid]);
+        if ((diff <= 0) or (diff * diff <= sqr_radius)) {
+            this->searchRadius(begin, mid, p, sqr_radius, res);
+        }
+        if ((diff >= 0) or (diff * diff <= sqr_radius)) {
+            this->searchRadius(mid + 1, end, p, sqr_radius, res);
+        }
+    }
+};
+
+
+// Uniform grid hashed into a power-of-two table with buckets stored contiguously (counting sort), so it takes
+// O(n) memory however sparse the points are. Best for radius queries with a radius near the cell size; nearest
+// queries walk rings of cells and suit query points inside the data's extent.
+class PointGrid {
+public:
+    PointGrid(const std::vector<Point>& points, double cell) : cell(cell), inv_cell(1 / cell) {
+        size_t n = points.size();
+        size_t table_size = 1;
+        while (table_size < n) {
+            table_size *= 2;
+        }
+        this->mask = table_size - 1;
+        std::vector<Entry> unsorted(n);
+        std::vector<size_t> buckets(n);
+        parallelChunks(n, kParallelQueryChunk, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                unsorted[i] = {points[i], this->cellOf(points[i].x), this->cellOf(points[i].y), i};
+                buckets[i] = this->bucket(unsorted[i].cx, unsorted[i].cy);
+            }
+        });
+        this->starts.assign(table_size + 1, 0);
+        for (size_t i = 0; i < n; ++i) {
+            ++this->starts[buckets[i] + 1];
+            this->cells.extend(Point(double(unsorted[i].cx), double(unsorted[i].cy)));
+        }
+        for (size_t i = 0; i < table_size; ++i) {
+            this->starts[i + 1] += this->starts[i];
+        }
+        this->entries.resize(n);
+        std::vector<size_t> fill(this->starts.begin(), this->starts.end() - 1);
+        for (size_t i = 0; i < n; ++i) {
+            this->entries[fill[buckets[i]]++] = unsorted[i];
+        }
+    }
+
+    size_t size() const {
+        return this->entries.size();
+    }
+
+    std::vector<size_t> radiusSearch(const Point& p, double radius) const {  // points within radius, boundary included
+        std::vector<size_t> res;
+        if (this->entries.empty()) {
+            return res;
+        }
+        double sqr_radius = radius * radius;
+        int64_t x_begin = std::max(this->cellOf(p.x - radius), int64_t(this->cells.min.x));
+        int64_t x_end = std::min(this->cellOf(p.x + radius), int64_t(this->cells.max.x));
+        int64_t y_begin = std::max(this->cellOf(p.y - radius), int64_t(this->cells.min.y));
+        int64_t y_end = std::min(this->cellOf(p.y + radius), int64_t(this->cells.max.y));
+        for (int64_t cy = y_begin; cy <= y_end; ++cy) {
+            for (int64_t cx = x_begin; cx <= x_end; ++cx) {
+                this->forEachInCell(cx, cy, [&](const Entry& entry) {
+                    if (sqrDistance(p, entry.point) <= sqr_radius) {
+                        res.push_back(entry.id);
+                    }
+                });
+            }
+        }
+        return res;
+    }
+
+    std::vector<std::vector<size_t>> radiusSearch(const std::vector<Point>& queries, double radius) const {
+        std::vector<std::vector<size_t>> res(queries.size());
+        parallelChunks(queries.size(), kParallelQueryChunk, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                res[i] = this->radiusSearch(queries[i], radius);
+            }
+        });
+        return res;
+    }
+
+    size_t nearest(const Point& p) const {  // kNoPoint if empty
+        if (this->entries.empty()) {
+            return kNoPoint;
+        }
+        int64_t cx = this->cellOf(p.x), cy = this->cellOf(p.y);
+        int64_t min_x = this->cells.min.x, max_x = this->cells.max.x;
+        int64_t min_y = this->cells.min.y, max_y = this->cells.max.y;
+        int64_t last_ring = std::max({cx - min_x, max_x - cx, cy - min_y, max_y - cy});
+        int64_t first_ring = std::max({int64_t(0), min_x - cx, cx - max_x, min_y - cy, cy - max_y});
+        double best_sqr = INFINITY;
+        size_t best = kNoPoint;
+        auto visit = [&](const Entry& entry) {
+            double d = sqrDistance(p, entry.point);
+            if ((d < best_sqr) or ((d == best_sqr) and (entry.id < best))) {
+                best_sqr = d;
+                best = entry.id;
+            }
+        };
+        for (int64_t ring = first_ring; ring <= last_ring; ++ring) {  // cells at Chebyshev distance ring
+            for (int64_t y = std::max(cy - ring, min_y); y <= std::min(cy + ring, max_y); ++y) {
+                if ((y == cy - ring) or (y == cy + ring)) {
+                    for (int64_t x = std::max(cx - ring, min_x); x <= std::min(cx + ring, max_x); ++x) {
+                        this->forEachInCell(x, y, visit);
+                    }
+                } else {
+                    if (cx - ring >= min_x) {
+                        this->forEachInCell(cx - ring, y, visit);
+                    }
+                    if (cx + ring <= max_x) {
+                        this->forEachInCell(cx + ring, y, visit);
+                    }
+                }
+            }
+            double reach = ring * this->cell;  // every cell of the next ring is at least this far
+            if (best_sqr <= reach * reach) {
+                break;
+            }
+        }
+        return best;
+    }
+
+    std::vector<size_t> nearest(const std::vector<Point>& queries) const {  // batched, in parallel
+        std::vector<size_t> res(queries.size());
+        parallelChunks(queries.size(), kParallelQueryChunk, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                res[i] = this->nearest(queries[i]);
+            }
+        });
+        return res;
+    }
+
+private:
+    struct Entry {
+        Point point;
+        int64_t cx;
+        int64_t cy;
+        size_t id;
+    };
+
+    double cell;
+    double inv_cell;
+    size_t mask;
+    BoundingBox cells;  // range of occupied cell coordinates
+    std::vector<size_t> starts;  // bucket b holds entries[starts[b]..starts[b + 1])
+    std::vector<Entry> entries;
+
+    int64_t cellOf(double coordinate) const {  // saturates far outside the data, the conversion would overflow
+        const double kLimit = 4.0e18;
+        return int64_t(std::max(-kLimit, std::min(std::floor(coordinate * this->inv_cell), kLimit)));
+    }
+
+    size_t bucket(int64_t cx, int64_t cy) const {
+        uint64_t h = uint64_t(cx) * 0x9E3779B97F4A7C15ull ^ uint64_t(cy) * 0xC2B2AE3D27D4EB4Full;
+        return size_t(h ^ (h >> 29)) & this->mask;
+    }
+
+    template <class Func>
+    void forEachInCell(int64_t cx, int64_t cy, Func func) const {  // the bucket may hold other cells as well
+        size_t b = this->bucket(cx, cy);
+        for (size_t i = this->starts[b]; i < this->starts[b + 1]; ++i) {
+            if ((this->entries[i].cx == cx) and (this->entries[i].cy == cy)) {
+                func(this->entries[i]);
+            }
+        }
+    }
+};
+
+
+// Indices of the two closest points (smaller index first); empty for fewer than two points.
+std::optional<std::pair<size_t, size_t>> closestPair(const std::vector<Point>& points) {
+    if (points.size() < 2) {
+        return std::nullopt;
+    }
+    std::vector<size_t> neighbors = PointKdTree(points).allNearestNeighbors();
+    size_t best = 0;
+    double best_sqr = INFINITY;
+    for (size_t i = 0; i < points.size(); ++i) {
+        double d = sqrDistance(points[i], points[neighbors[i]]);
+        if (d < best_sqr) {
+            best_sqr = d;
+            best = i;
+        }
+    }
+    return std::make_pair(std::min(best, neighbors[best]), std::max(best, neighbors[best]));
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+
+#include "geometry.h"
+
+
+// Vertices of many polygons packed into one shared array, polygon i owning the slice [offsets[i], offsets[i + 1]).
+// Adding a polygon appends to the array instead of allocating a vector per shape, so after reserve() building
+// millions of small polygons does not allocate at all, and walking them in order reads memory sequentially.
+// Polygons are read through VertexSpan with the polygon* functions of geometry.h. Spans are invalidated by add().
+
+class PolygonArena {
+public:
+    PolygonArena() : offsets{0} {}
+
+    void reserve(size_t polygons, size_t vertices) {
+        this->offsets.reserve(polygons + 1);
+        this->points.reserve(vertices);
+    }
+
+    size_t add(VertexSpan vertices) {  // returns the index of the polygon; vertices may be another polygon of the arena
+        std::less<const Point*> before;
+        const Point* begin = this->points.data();
+        if (!before(vertices.data(), begin) and before(vertices.data(), begin + this->points.size())) {
+            size_t from = vertices.data() - begin, size = this->points.size();  // offsets survive reallocation
+            this->points.resize(size + vertices.size());
+            std::copy_n(this->points.begin() + from, vertices.size(), this->points.begin() + size);
+        } else {
+            this->points.insert(this->points.end(), vertices.begin(), vertices.end());
+        }
+        this->offsets.push_back(this->points.size());
+        return this->offsets.size() - 2;
+    }
+
+    size_t add(std::initializer_list<Point> vertices) {
+        return this->add(VertexSpan(vertices.begin(), vertices.size()));
+    }
+
+    size_t size() const {  // number of polygons
+        return this->offsets.size() - 1;
+    }
+
+    size_t verticesCount() const {  // over all polygons
+        return this->points.size();
+    }
+
+    VertexSpan operator[](size_t i) const {
+        return VertexSpan(this->points.data() + this->offsets[i], this->offsets[i + 1] - this->offsets[i]);
+    }
+
+    Polygon toPolygon(size_t i) const {
+        VertexSpan vertices = (*this)[i];
+        return Polygon(std::vector<Point>(vertices.begin(), vertices.end()));
+    }
+
+    void clear() {  // keeps the capacity
+        this->points.clear();
+        this->offsets.resize(1);
+    }
+
+private:
+    std::vector<Point> points;
+    std::vector<size_t> offsets;
+};
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <utility>
+
+#include "geometry.h"
+
+
+const size_t kSoALanes = 8;  // independent accumulators, one SIMD register or two
+
+
+// Kernels over coordinate arrays shared by PolygonSoA and CompactPolygon. Both walk the open chain of n points
+// (n - 1 edges) and accumulate in kSoALanes independent sums, so the loops vectorize without -ffast-math. They are
+// inline: with several callers GCC otherwise keeps them out of line, which costs about 7% in PolygonSoA::area.
+
+inline double sumLanes(const double* acc) {
+    double res = 0;
+    for (size_t k = 0; k < kSoALanes; ++k) {
+        res += acc[k];
+    }
+    return res;
+}
+
+
+// shoelace terms of the chain around (x0, y0); twice the signed area once the chain is closed
+inline double chainCrossSum(const double* x, const double* y, size_t n, double x0, double y0) {
+    double acc[kSoALanes] = {};
+    size_t i = 0;
+    for (; i + kSoALanes < n; i += kSoALanes) {
+        for (size_t k = 0; k < kSoALanes; ++k) {
+            double ax = x[i + k] - x0, ay = y[i + k] - y0;
+            double bx = x[i + k + 1] - x0, by = y[i + k + 1] - y0;
+            acc[k] += ax * by - bx * ay;
+        }
+    }
+    double res = sumLanes(acc);
+    for (; i + 1 < n; ++i) {
+        res += (x[i] - x0) * (y[i + 1] - y0) - (x[i + 1] - x0) * (y[i] - y0);
+    }
+    return res;
+}
+
+
+inline double chainLength(const double* x, const double* y, size_t n) {  // sqrt per edge: hypot does not vectorize
+    double acc[kSoALanes] = {};
+    size_t i = 0;
+    for (; i + kSoALanes < n; i += kSoALanes) {
+        for (size_t k = 0; k < kSoALanes; ++k) {
+            double dx = x[i + k + 1] - x[i + k], dy = y[i + k + 1] - y[i + k];
+            acc[k] += sqrt(dx * dx + dy * dy);
+        }
+    }
+    double res = sumLanes(acc);
+    for (; i + 1 < n; ++i) {
+        res += sqrt(calcSqrSum(x[i + 1] - x[i], y[i + 1] - y[i]));
+    }
+    return res;
+}
+
+
+class PolygonSoA {  // polygon vertices as separate x[] and y[] arrays, for bulk area / perimeter
+public:
+    explicit PolygonSoA(const Polygon& polygon) {
+        const auto& vertices = polygon.getVertices();
+        this->xs.resize(vertices.size());
+        this->ys.resize(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            this->xs[i] = vertices[i].x;
+            this->ys[i] = vertices[i].y;
+        }
+    }
+
+    PolygonSoA(std::vector<double> xs, std::vector<double> ys) : xs(std::move(xs)), ys(std::move(ys)) {}
+
+    size_t verticesCount() const {
+        return this->xs.size();
+    }
+
+    const std::vector<double>& getXs() const {
+        return this->xs;
+    }
+
+    const std::vector<double>& getYs() const {
+        return this->ys;
+    }
+
+    Polygon toPolygon() const {
+        std::vector<Point> vertices(this->xs.size());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            vertices[i] = Point(this->xs[i], this->ys[i]);
+        }
+        return Polygon(vertices);
+    }
+
+    // shoelace relative to vertex 0, same terms as the fan in Polygon::area
+    double area() const {
+        size_t n = this->xs.size();
+        if (n < 3) {
+            return 0;
+        }
+        const double* x = this->xs.data();
+        const double* y = this->ys.data();
+        return 0.5 * std::abs(chainCrossSum(x + 1, y + 1, n - 1, x[0], y[0]));
+    }
+
+    double perimeter() const {
+        size_t n = this->xs.size();
+        if (n < 2) {
+            return 0;
+        }
+        const double* x = this->xs.data();
+        const double* y = this->ys.data();
+        return chainLength(x, y, n) + sqrt(calcSqrSum(x[0] - x[n - 1], y[0] - y[n - 1]));  // closing edge
+    }
+
+private:
+    std::vector<double> xs;
+    std::vector<double> ys;
+};
+
+
+struct TriangleCentersSoA {  // TriangleCenters of many triangles, one array per field
+    std::vector<double> circumcenter_x, circumcenter_y, circumradius;
+    std::vector<double> incenter_x, incenter_y, inradius;
+    std::vector<double> centroid_x, centroid_y;
+    std::vector<double> orthocenter_x, orthocenter_y;
+    std::vector<double> nine_point_x, nine_point_y, nine_point_radius;
+};
+
+
+class TrianglesSoA {  // vertices a, b, c of many triangles as six coordinate arrays
+public:
+    explicit TrianglesSoA(const std::vector<Triangle>& triangles) {
+        for (auto coords : {&this->ax, &this->ay, &this->bx, &this->by, &this->cx, &this->cy}) {
+            coords->resize(triangles.size());
+        }
+        for (size_t i = 0; i < triangles.size(); ++i) {
+            const auto& v = triangles[i].getVertices();
+            this->ax[i] = v[0].x;
+            this->ay[i] = v[0].y;
+            this->bx[i] = v[1].x;
+            this->by[i] = v[1].y;
+            this->cx[i] = v[2].x;
+            this->cy[i] = v[2].y;
+        }
+    }
+
+    TrianglesSoA(std::vector<double> ax, std::vector<double> ay, std::vector<double> bx, std::vector<double> by,
+                 std::vector<double> cx, std::vector<double> cy)
+        : ax(std::move(ax)), ay(std::move(ay)), bx(std::move(bx)), by(std::move(by)), cx(std::move(cx)),
+          cy(std::move(cy)) {}
+
+    size_t size() const {
+        return this->ax.size();
+    }
+
+    TriangleCentersSoA centers() const {
+        TriangleCentersSoA res;
+        this->centers(res);
+        return res;
+    }
+
+    // The formulas of triangleCenters in one branch-free loop, vectorized with -O3 -march=native; res keeps its
+    // buffers between calls of the same size.
+    void centers(TriangleCentersSoA& res) const {
+        size_t n = this->size();
+        for (auto field : {&res.circumcenter_x, &res.circumcenter_y, &res.circumradius, &res.incenter_x,
+                           &res.incenter_y, &res.inradius, &res.centroid_x, &res.centroid_y, &res.orthocenter_x,
+                           &res.orthocenter_y, &res.nine_point_x, &res.nine_point_y, &res.nine_point_radius}) {
+            field->resize(n);
+        }
+        const double* ax = this->ax.data();
+        const double* ay = this->ay.data();
+        const double* bx = this->bx.data();
+        const double* by = this->by.data();
+        const double* cx = this->cx.data();
+        const double* cy = this->cy.data();
+        double* ox = res.circumcenter_x.data();
+        double* oy = res.circumcenter_y.data();
+        double* r = res.circumradius.data();
+        double* ix = res.incenter_x.data();
+        double* iy = res.incenter_y.data();
+        double* ir = res.inradius.data();
+        double* gx = res.centroid_x.data();
+        double* gy = res.centroid_y.data();
+        double* hx = res.orthocenter_x.data();
+        double* hy = res.orthocenter_y.data();
+        double* nx = res.nine_point_x.data();
+        double* ny = res.nine_point_y.data();
+        double* nr = res.nine_point_radius.data();
+#pragma GCC ivdep  // the arrays never overlap; too many of them for runtime alias checks
+        for (size_t i = 0; i < n; ++i) {
+            double ux = bx[i] - ax[i], uy = by[i] - ay[i];
+            double vx = cx[i] - ax[i], vy = cy[i] - ay[i];
+            double sqr_u = ux * ux + uy * uy, sqr_v = vx * vx + vy * vy;
+            double k = 2 * (ux * vy - uy * vx);
+            double dx = (vy * sqr_u - uy * sqr_v) / k;
+            double dy = (ux * sqr_v - vx * sqr_u) / k;
+            double side_a = sqrt((cx[i] - bx[i]) * (cx[i] - bx[i]) + (cy[i] - by[i]) * (cy[i] - by[i]));
+            double side_b = sqrt(sqr_v), side_c = sqrt(sqr_u);
+            double p = side_a + side_b + side_c;
+            double sum_x = ax[i] + bx[i] + cx[i], sum_y = ay[i] + by[i] + cy[i];
+            ox[i] = ax[i] + dx;
+            oy[i] = ay[i] + dy;
+            r[i] = sqrt(dx * dx + dy * dy);
+            ix[i] = (side_a * ax[i] + side_b * bx[i] + side_c * cx[i]) / p;
+            iy[i] = (side_a * ay[i] + side_b * by[i] + side_c * cy[i]) / p;
+            ir[i] = std::abs(k) * 0.5 / p;
+            gx[i] = sum_x / 3;
+            gy[i] = sum_y / 3;
+            hx[i] = sum_x - 2 * ox[i];
+            hy[i] = sum_y - 2 * oy[i];
+            nx[i] = ax[i] + (ux + vx - dx) * 0.5;
+            ny[i] = ay[i] + (uy + vy - dy) * 0.5;
+            nr[i] = r[i] * 0.5;
+        }
+    }
+
+private:
+    std::vector<double> ax, ay, bx, by, cx, cy;
+};
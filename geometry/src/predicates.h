@@ -0,0 +1,186 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <cfloat>
+
+
+// Robust geometric predicates after Shewchuk, "Adaptive Precision Floating-Point Arithmetic and Fast Robust
+// Geometric Predicates". Each predicate first evaluates the determinant in plain doubles and accepts its sign when
+// the value exceeds a forward error bound; only near-degenerate inputs are re-evaluated exactly with floating-point
+// expansions. The returned value has the sign of the exact determinant. Requires IEEE doubles without -ffast-math
+// and products that do not underflow.
+
+const double kRoundoff = DBL_EPSILON / 2;  // 2^-53, half an ulp of 1
+const double kOrientErrorBound = (3 + 16 * kRoundoff) * kRoundoff;
+const double kInCircleErrorBound = (10 + 96 * kRoundoff) * kRoundoff;
+
+
+typedef std::vector<double> Expansion;  // nonoverlapping components, increasing magnitude
+
+
+void twoSum(double a, double b, double& x, double& y) {  // x + y == a + b exactly
+    x = a + b;
+    double bv = x - a;
+    double av = x - bv;
+    y = (a - av) + (b - bv);
+}
+
+
+void twoProduct(double a, double b, double& x, double& y) {  // x + y == a * b exactly
+    x = a * b;
+    y = std::fma(a, b, -x);
+}
+
+
+Expansion growExpansion(const Expansion& e, double b) {
+    Expansion res;
+    res.reserve(e.size() + 1);
+    double q = b;
+    for (double component : e) {
+        double sum, err;
+        twoSum(q, component, sum, err);
+        if (err != 0) {
+            res.push_back(err);
+        }
+        q = sum;
+    }
+    if ((q != 0) or res.empty()) {
+        res.push_back(q);
+    }
+    return res;
+}
+
+
+Expansion sumExpansions(const Expansion& e, const Expansion& f) {
+    Expansion res = e;
+    for (double component : f) {
+        res = growExpansion(res, component);
+    }
+    return res;
+}
+
+
+Expansion scaleExpansion(const Expansion& e, double b) {
+    Expansion res = {0};
+    for (double component : e) {
+        double product, err;
+        twoProduct(component, b, product, err);
+        res = growExpansion(growExpansion(res, err), product);
+    }
+    return res;
+}
+
+
+Expansion multiplyExpansions(const Expansion& e, const Expansion& f) {
+    Expansion res = {0};
+    for (double component : f) {
+        res = sumExpansions(res, scaleExpansion(e, component));
+    }
+    return res;
+}
+
+
+Expansion negateExpansion(Expansion e) {
+    for (double& component : e) {
+        component = -component;
+    }
+    return e;
+}
+
+
+Expansion exactDifference(double a, double b) {  // exact a - b as two components
+    double x, y;
+    twoSum(a, -b, x, y);
+    return y != 0 ? Expansion{y, x} : Expansion{x};
+}
+
+
+double estimateExpansion(const Expansion& e) {  // approximate value with the sign of the exact one
+    double res = 0;
+    for (double component : e) {
+        res += component;
+    }
+    return res;
+}
+
+
+double orient2dExact(double ax, double ay, double bx, double by, double cx, double cy) {
+    Expansion left = multiplyExpansions(exactDifference(ax, cx), exactDifference(by, cy));
+    Expansion right = multiplyExpansions(exactDifference(ay, cy), exactDifference(bx, cx));
+    return estimateExpansion(sumExpansions(left, negateExpansion(right)));
+}
+
+
+// > 0 if a, b, c turn counterclockwise, < 0 clockwise, 0 if collinear; about twice the signed triangle area
+double orient2d(double ax, double ay, double bx, double by, double cx, double cy) {
+    double left = (ax - cx) * (by - cy);
+    double right = (ay - cy) * (bx - cx);
+    double det = left - right;
+    double sum;
+    if (left > 0) {
+        if (right <= 0) {
+            return det;
+        }
+        sum = left + right;
+    } else if (left < 0) {
+        if (right >= 0) {
+            return det;
+        }
+        sum = -left - right;
+    } else {
+        return det;
+    }
+    double bound = kOrientErrorBound * sum;
+    if ((det >= bound) or (-det >= bound)) {
+        return det;
+    }
+    return orient2dExact(ax, ay, bx, by, cx, cy);
+}
+
+
+double incircleExact(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy) {
+    Expansion adx = exactDifference(ax, dx), ady = exactDifference(ay, dy);
+    Expansion bdx = exactDifference(bx, dx), bdy = exactDifference(by, dy);
+    Expansion cdx = exactDifference(cx, dx), cdy = exactDifference(cy, dy);
+    auto lift = [](const Expansion& x, const Expansion& y) {
+        return sumExpansions(multiplyExpansions(x, x), multiplyExpansions(y, y));
+    };
+    auto minor = [](const Expansion& px, const Expansion& py, const Expansion& qx, const Expansion& qy) {
+        return sumExpansions(multiplyExpansions(px, qy), negateExpansion(multiplyExpansions(qx, py)));
+    };
+    Expansion det = multiplyExpansions(lift(adx, ady), minor(bdx, bdy, cdx, cdy));
+    det = sumExpansions(det, multiplyExpansions(lift(bdx, bdy), minor(cdx, cdy, adx, ady)));
+    det = sumExpansions(det, multiplyExpansions(lift(cdx, cdy), minor(adx, ady, bdx, bdy)));
+    return estimateExpansion(det);
+}
+
+
+// > 0 if d lies inside the circle through counterclockwise a, b, c, < 0 outside, 0 on it (signs flip for clockwise)
+double incircle(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy) {
+    double adx = ax - dx, ady = ay - dy;
+    double bdx = bx - dx, bdy = by - dy;
+    double cdx = cx - dx, cdy = cy - dy;
+    double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    double alift = adx * adx + ady * ady;
+    double cdxady = cdx * ady, adxcdy = adx * cdy;
+    double blift = bdx * bdx + bdy * bdy;
+    double adxbdy = adx * bdy, bdxady = bdx * ady;
+    double clift = cdx * cdx + cdy * cdy;
+    double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+    double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift + (std::abs(cdxady) + std::abs(adxcdy)) * blift +
+                       (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+    double bound = kInCircleErrorBound * permanent;
+    if ((det > bound) or (-det > bound)) {
+        return det;
+    }
+    return incircleExact(ax, ay, bx, by, cx, cy, dx, dy);
+}
+
+
+double det2(double a, double b, double c, double d) {  // a * d - b * c from exact products, correct sign
+    double ad, ad_err, bc, bc_err;
+    twoProduct(a, d, ad, ad_err);
+    twoProduct(b, c, bc, bc_err);
+    return estimateExpansion(sumExpansions({ad_err, ad}, {-bc_err, -bc}));
+}
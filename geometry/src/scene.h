@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+#include <type_traits>
+
+#include "geometry.h"
+#include "shape_store.h"
+#include "parallel.h"
+
+
+// Scene-wide reductions over many shapes on all cores. The shapes are cut into blocks of kSceneBlock, each block is
+// summed in order on one thread and the block sums are added in block order, so the result does not depend on the
+// number of threads or on scheduling. Measuring only reads the shapes, so one shape may appear any number of times.
+
+const size_t kSceneBlock = 1 << 12;
+
+
+struct SceneMeasures {
+    double area = 0;
+    double perimeter = 0;
+    BoundingBox box;  // empty for an empty scene
+
+    void add(const SceneMeasures& rhs) {
+        this->area += rhs.area;
+        this->perimeter += rhs.perimeter;
+        this->box.extend(rhs.box);
+    }
+};
+
+
+template <class Measure>
+SceneMeasures reduceSceneBlocks(size_t count, Measure measure) {  // measure(begin, end) of one block
+    std::vector<SceneMeasures> partial((count + kSceneBlock - 1) / kSceneBlock);
+    parallelBlocks(count, kSceneBlock, [&](size_t begin, size_t end) {
+        partial[begin / kSceneBlock] = measure(begin, end);
+    });
+    SceneMeasures res;
+    for (const auto& block : partial) {
+        res.add(block);
+    }
+    return res;
+}
+
+
+SceneMeasures measureScene(const std::vector<Shape*>& shapes) {
+    return reduceSceneBlocks(shapes.size(), [&shapes](size_t begin, size_t end) {
+        SceneMeasures res;
+        for (size_t i = begin; i < end; ++i) {
+            res.area += shapes[i]->area();
+            res.perimeter += shapes[i]->perimeter();
+            res.box.extend(shapes[i]->boundingBox());
+        }
+        return res;
+    });
+}
+
+
+SceneMeasures measureScene(const ShapeStore& store) {  // type by type, with statically bound calls
+    SceneMeasures res;
+    auto measure_type = [&res](const auto& shapes) {
+        typedef typename std::decay_t<decltype(shapes)>::value_type T;
+        res.add(reduceSceneBlocks(shapes.size(), [&shapes](size_t begin, size_t end) {
+            SceneMeasures block;
+            for (size_t i = begin; i < end; ++i) {
+                block.area += shapes[i].T::area();
+                block.perimeter += shapes[i].T::perimeter();
+                block.box.extend(shapes[i].T::boundingBox());
+            }
+            return block;
+        }));
+    };
+    measure_type(store.get<Polygon>());
+    measure_type(store.get<Ellipse>());
+    measure_type(store.get<Circle>());
+    measure_type(store.get<Rectangle>());
+    measure_type(store.get<Square>());
+    measure_type(store.get<Triangle>());
+    return res;
+}
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <istream>
+#include <ostream>
+#include <optional>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <variant>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "geometry.h"
+#include "shape_store.h"
+
+
+// Binary shape format, host byte order (little-endian on every supported target):
+//   header: "GSHP", uint32 version
+//   record: uint8 tag (index of the type in ShapeVariant), uint32 vertex count, 2 * count packed doubles,
+//           then one more double for Ellipse (a2, the sum of focal distances) and Circle (the radius)
+// Ellipse records hold both focuses, Circle records the center.
+
+const char kShapeFormatMagic[4] = {'G', 'S', 'H', 'P'};
+const uint32_t kShapeFormatVersion = 1;
+const size_t kShapeReaderBuffer = 1 << 20;  // bytes read from a stream at once
+const size_t kShapeReaderChunk = 1 << 16;  // vertices allocated at once, so a corrupt count cannot exhaust memory
+
+// Record tags are part of the format. Each one must stay the index of its type in ShapeVariant, which
+// ShapeReader relies on; reordering the variant fails to compile instead of silently changing the format.
+const uint8_t kPolygonTag = 0;
+const uint8_t kEllipseTag = 1;
+const uint8_t kCircleTag = 2;
+const uint8_t kRectangleTag = 3;
+const uint8_t kSquareTag = 4;
+const uint8_t kTriangleTag = 5;
+const uint8_t kShapeTagCount = 6;
+
+static_assert(std::is_same<std::variant_alternative_t<kPolygonTag, ShapeVariant>, Polygon>::value, "tag order");
+static_assert(std::is_same<std::variant_alternative_t<kEllipseTag, ShapeVariant>, Ellipse>::value, "tag order");
+static_assert(std::is_same<std::variant_alternative_t<kCircleTag, ShapeVariant>, Circle>::value, "tag order");
+static_assert(std::is_same<std::variant_alternative_t<kRectangleTag, ShapeVariant>, Rectangle>::value, "tag order");
+static_assert(std::is_same<std::variant_alternative_t<kSquareTag, ShapeVariant>, Square>::value, "tag order");
+static_assert(std::is_same<std::variant_alternative_t<kTriangleTag, ShapeVariant>, Triangle>::value, "tag order");
+static_assert(std::variant_size<ShapeVariant>::value == kShapeTagCount, "every shape type has a tag");
+
+
+class ShapeWriter {
+public:
+    explicit ShapeWriter(std::ostream& out) : out(out) {
+        this->out.write(kShapeFormatMagic, sizeof(kShapeFormatMagic));
+        this->put(kShapeFormatVersion);
+    }
+
+    void write(const Polygon& shape) { this->writeRecord(kPolygonTag, shape.getVertices()); }
+    void write(const Rectangle& shape) { this->writeRecord(kRectangleTag, shape.getVertices()); }
+    void write(const Square& shape) { this->writeRecord(kSquareTag, shape.getVertices()); }
+    void write(const Triangle& shape) { this->writeRecord(kTriangleTag, shape.getVertices()); }
+
+    void write(const Ellipse& shape) {
+        this->writeRecord(kEllipseTag, {shape.focuses().first, shape.focuses().second});
+        this->put(2 * shape.radius());
+    }
+
+    void write(const Circle& shape) {
+        this->writeRecord(kCircleTag, {shape.center()});
+        this->put(shape.radius());
+    }
+
+    void write(const ShapeVariant& shape) {
+        std::visit([this](const auto& concrete) { this->write(concrete); }, shape);
+    }
+
+    void write(const ShapeStore& store) {  // grouped by type, not in insertion order
+        store.visit([this](const auto& concrete) { this->write(concrete); });
+    }
+
+    bool failed() const {
+        return this->out.fail();
+    }
+
+private:
+    std::ostream& out;
+
+    template <class T>
+    void put(const T& value) {
+        this->out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void writeRecord(uint8_t tag, const std::vector<Point>& vertices) {
+        this->put(tag);
+        this->put(uint32_t(vertices.size()));
+        static_assert(sizeof(Point) == 2 * sizeof(double), "vertices are written as packed coordinate pairs");
+        this->out.write(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(Point));
+    }
+};
+
+
+class MappedFile {  // read-only mmap of a whole file; isOpen() is false if the file cannot be opened
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat info;
+        if (::fstat(fd, &info) == 0) {
+            this->length = size_t(info.st_size);
+            this->open = true;
+            if (this->length > 0) {
+                void* mapping = ::mmap(nullptr, this->length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapping == MAP_FAILED) {
+                    this->open = false;
+                    this->length = 0;
+                } else {
+                    this->bytes = static_cast<const char*>(mapping);
+                    ::madvise(mapping, this->length, MADV_SEQUENTIAL);
+                }
+            }
+        }
+        ::close(fd);  // the mapping stays valid
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (this->bytes != nullptr) {
+            ::munmap(const_cast<char*>(this->bytes), this->length);
+        }
+    }
+
+    bool isOpen() const {
+        return this->open;
+    }
+
+    const char* data() const {
+        return this->bytes;
+    }
+
+    size_t size() const {
+        return this->length;
+    }
+
+private:
+    const char* bytes = nullptr;
+    size_t length = 0;
+    bool open = false;
+};
+
+
+// Reads records one at a time from a stream (through an internal buffer) or from bytes already in memory, e.g. a
+// MappedFile, which must outlive the reader. Every polygon gets one vertex array filled by memcpy.
+class ShapeReader {
+public:
+    explicit ShapeReader(std::istream& in) : in(&in), buffer(kShapeReaderBuffer) {
+        this->readHeader();
+    }
+
+    ShapeReader(const char* data, size_t size) : in(nullptr), cursor(data), end(data + size) {
+        this->readHeader();
+    }
+
+    // The next shape, or nullopt at the end of the input or at a malformed record (then failed() is true).
+    std::optional<ShapeVariant> next() {
+        std::optional<ShapeVariant> res;
+        this->parse([&res](auto&& shape) { res.emplace(std::move(shape)); });
+        return res;
+    }
+
+    size_t readAll(ShapeStore& store) {  // returns the number of shapes added
+        size_t res = 0;
+        while (this->parse([&store](auto&& shape) { store.add(std::move(shape)); })) {
+            ++res;
+        }
+        return res;
+    }
+
+    bool failed() const {  // bad header, unknown tag or truncated record
+        return this->bad;
+    }
+
+private:
+    std::istream* in;  // null when reading from memory
+    std::vector<char> buffer;
+    const char* cursor = nullptr;
+    const char* end = nullptr;
+    bool bad = false;
+
+    template <class Func>
+    bool parse(Func func) {  // calls func with the next shape as its concrete type; false at the end or on error
+        if (this->bad or ((this->cursor == this->end) and !this->refill())) {
+            return false;
+        }
+        uint8_t tag;
+        uint32_t count;
+        if (!this->get(tag) or !this->get(count)) {
+            return this->fail();
+        }
+        if ((tag >= kShapeTagCount) or ((fixedCount(tag) != 0) and (count != fixedCount(tag)))) {
+            return this->fail();
+        }
+        Point fixed[3];  // ellipses, circles and triangles are built without a temporary vertex array
+        double extra;
+        if ((tag == kEllipseTag) or (tag == kCircleTag) or (tag == kTriangleTag)) {
+            if (!this->read(fixed, count * sizeof(Point)) or ((tag != kTriangleTag) and !this->get(extra))) {
+                return this->fail();
+            }
+            if (tag == kEllipseTag) {
+                func(Ellipse(fixed[0], fixed[1], extra));
+            } else if (tag == kCircleTag) {
+                func(Circle(fixed[0], extra));
+            } else {
+                func(Triangle(fixed[0], fixed[1], fixed[2]));
+            }
+            return true;
+        }
+        std::vector<Point> vertices;
+        if (!this->getVertices(count, vertices)) {
+            return this->fail();
+        }
+        if (tag == kPolygonTag) {
+            func(Polygon(std::move(vertices)));
+        } else if (tag == kRectangleTag) {
+            func(Rectangle(std::move(vertices)));
+        } else {
+            func(Square(std::move(vertices)));
+        }
+        return true;
+    }
+
+    static uint32_t fixedCount(uint8_t tag) {  // vertices a record of this type must have, 0 for any
+        switch (tag) {
+            case kEllipseTag: return 2;
+            case kCircleTag: return 1;
+            case kRectangleTag: return 4;
+            case kSquareTag: return 4;
+            case kTriangleTag: return 3;
+            default: return 0;
+        }
+    }
+
+    bool fail() {
+        this->bad = true;
+        return false;
+    }
+
+    bool refill() {
+        if ((this->in == nullptr) or !*this->in) {
+            return false;
+        }
+        this->in->read(this->buffer.data(), this->buffer.size());
+        this->cursor = this->buffer.data();
+        this->end = this->cursor + this->in->gcount();
+        return this->cursor != this->end;
+    }
+
+    bool read(void* destination, size_t bytes) {
+        char* out = static_cast<char*>(destination);
+        while (bytes > 0) {
+            if ((this->cursor == this->end) and !this->refill()) {
+                return false;
+            }
+            size_t available = std::min(bytes, size_t(this->end - this->cursor));
+            std::memcpy(out, this->cursor, available);
+            this->cursor += available;
+            out += available;
+            bytes -= available;
+        }
+        return true;
+    }
+
+    template <class T>
+    bool get(T& value) {
+        return this->read(&value, sizeof(value));
+    }
+
+    bool getVertices(size_t count, std::vector<Point>& vertices) {
+        if ((this->in == nullptr) and (count > size_t(this->end - this->cursor) / sizeof(Point))) {
+            return false;  // truncated; checked before allocating
+        }
+        for (size_t done = 0; done < count;) {
+            size_t chunk = this->in == nullptr ? count : std::min(count - done, kShapeReaderChunk);
+            vertices.resize(done + chunk);
+            if (!this->read(vertices.data() + done, chunk * sizeof(Point))) {
+                return false;
+            }
+            done += chunk;
+        }
+        return true;
+    }
+
+    void readHeader() {
+        char magic[sizeof(kShapeFormatMagic)];
+        uint32_t version;
+        if (!this->read(magic, sizeof(magic)) or !this->get(version) or
+            (std::memcmp(magic, kShapeFormatMagic, sizeof(magic)) != 0) or (version != kShapeFormatVersion)) {
+            this->bad = true;
+        }
+    }
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <vector>
+#include <tuple>
+#include <variant>
+#include <utility>
+
+#include "geometry.h"
+
+
+typedef std::variant<Polygon, Ellipse, Circle, Rectangle, Square, Triangle> ShapeVariant;
+
+
+class ShapeStore {  // one contiguous array per concrete shape type, no virtual dispatch in bulk operations
+public:
+    template <class T>
+    size_t add(T shape) {  // returns the index within the array of T
+        auto& shapes = std::get<std::vector<T>>(this->arrays);
+        shapes.push_back(std::move(shape));
+        return shapes.size() - 1;
+    }
+
+    size_t add(const ShapeVariant& shape) {
+        return std::visit([this](const auto& concrete) { return this->add(concrete); }, shape);
+    }
+
+    template <class T>
+    std::vector<T>& get() {
+        return std::get<std::vector<T>>(this->arrays);
+    }
+
+    template <class T>
+    const std::vector<T>& get() const {
+        return std::get<std::vector<T>>(this->arrays);
+    }
+
+    size_t size() const {
+        size_t res = 0;
+        this->forEachArray([&res](const auto& shapes) { res += shapes.size(); });
+        return res;
+    }
+
+    // calls visitor(shape) with the concrete type of every shape, type by type,
+    // so an overload set written for std::visit on ShapeVariant works here too
+    template <class Visitor>
+    void visit(Visitor&& visitor) {
+        this->forEachArray([&visitor](auto& shapes) {
+            for (auto& shape : shapes) {
+                visitor(shape);
+            }
+        });
+    }
+
+    template <class Visitor>
+    void visit(Visitor&& visitor) const {
+        this->forEachArray([&visitor](const auto& shapes) {
+            for (const auto& shape : shapes) {
+                visitor(shape);
+            }
+        });
+    }
+
+    template <class T>
+    std::vector<double> areas() const {  // qualified calls bind statically and inline
+        const auto& shapes = this->get<T>();
+        std::vector<double> res(shapes.size());
+        for (size_t i = 0; i < shapes.size(); ++i) {
+            res[i] = shapes[i].T::area();
+        }
+        return res;
+    }
+
+    template <class T>
+    std::vector<double> perimeters() const {
+        const auto& shapes = this->get<T>();
+        std::vector<double> res(shapes.size());
+        for (size_t i = 0; i < shapes.size(); ++i) {
+            res[i] = shapes[i].T::perimeter();
+        }
+        return res;
+    }
+
+    double totalArea() const {
+        double res = 0;
+        this->forEachArray([&res](const auto& shapes) {
+            typedef typename std::decay_t<decltype(shapes)>::value_type T;
+            for (const auto& shape : shapes) {
+                res += shape.T::area();
+            }
+        });
+        return res;
+    }
+
+    double totalPerimeter() const {
+        double res = 0;
+        this->forEachArray([&res](const auto& shapes) {
+            typedef typename std::decay_t<decltype(shapes)>::value_type T;
+            for (const auto& shape : shapes) {
+                res += shape.T::perimeter();
+            }
+        });
+        return res;
+    }
+
+    void transform(const AffineTransform& t) {
+        this->forEachArray([&t](auto& shapes) {
+            typedef typename std::decay_t<decltype(shapes)>::value_type T;
+            for (auto& shape : shapes) {
+                shape.T::transform(t);
+            }
+        });
+    }
+
+private:
+    template <class Func>
+    void forEachArray(Func func) {
+        std::apply([&func](auto&... shapes) { (func(shapes), ...); }, this->arrays);
+    }
+
+    template <class Func>
+    void forEachArray(Func func) const {
+        std::apply([&func](const auto&... shapes) { (func(shapes), ...); }, this->arrays);
+    }
+
+    std::tuple<std::vector<Polygon>, std::vector<Ellipse>, std::vector<Circle>,
+               std::vector<Rectangle>, std::vector<Square>, std::vector<Triangle>> arrays;
+};
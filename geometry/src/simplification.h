@@ -0,0 +1,123 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <tuple>
+
+#include "geometry.h"
+
+
+double sqrSegmentDistance(const Point& p, const Point& a, const Point& b) {
+    double dx = b.x - a.x, dy = b.y - a.y;
+    double len2 = calcSqrSum(dx, dy);
+    double t = len2 > 0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / len2 : 0;
+    t = std::max(0.0, std::min(1.0, t));
+    return calcSqrSum(p.x - a.x - t * dx, p.y - a.y - t * dy);
+}
+
+
+// Douglas-Peucker on a closed contour: the polygon is split at vertex 0 and the vertex farthest from it, each chain
+// is simplified with an explicit stack. Every removed vertex lies within tolerance of the result.
+Polygon simplifyDouglasPeucker(const Polygon& polygon, double tolerance) {
+    const auto& vertices = polygon.getVertices();
+    size_t n = vertices.size();
+    if (n <= 3) {
+        return polygon;
+    }
+    size_t far = 0;
+    double far_dist = -1;
+    for (size_t i = 1; i < n; ++i) {
+        double dist = calcSqrSum(vertices[i].x - vertices[0].x, vertices[i].y - vertices[0].y);
+        if (dist > far_dist) {
+            far = i;
+            far_dist = dist;
+        }
+    }
+    double tolerance2 = tolerance * tolerance;
+    std::vector<char> keep(n, 0);
+    keep[0] = keep[far] = 1;
+    std::vector<std::pair<size_t, size_t>> stack = {{0, far}, {far, n}};  // index n stands for vertex 0
+    while (!stack.empty()) {
+        auto [first, last] = stack.back();
+        stack.pop_back();
+        const Point& a = vertices[first];
+        const Point& b = vertices[last % n];
+        size_t split = first;
+        double split_dist = tolerance2;
+        for (size_t i = first + 1; i < last; ++i) {
+            double dist = sqrSegmentDistance(vertices[i], a, b);
+            if (dist > split_dist) {
+                split = i;
+                split_dist = dist;
+            }
+        }
+        if (split != first) {
+            keep[split] = 1;
+            stack.emplace_back(first, split);
+            stack.emplace_back(split, last);
+        }
+    }
+    std::vector<Point> res;
+    for (size_t i = 0; i < n; ++i) {
+        if (keep[i]) {
+            res.push_back(vertices[i]);
+        }
+    }
+    return Polygon(res);
+}
+
+
+// Visvalingam-Whyatt: repeatedly drops the vertex whose triangle with its neighbours has the smallest area,
+// while that area is below min_area and more than three vertices remain. Heap with lazy invalidation.
+Polygon simplifyVisvalingam(const Polygon& polygon, double min_area) {
+    const auto& vertices = polygon.getVertices();
+    size_t n = vertices.size();
+    if (n <= 3) {
+        return polygon;
+    }
+    std::vector<size_t> prev(n), next(n), version(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        prev[i] = (i + n - 1) % n;
+        next[i] = (i + 1) % n;
+    }
+    auto effective_area = [&](size_t i) {
+        const Point& a = vertices[prev[i]];
+        const Point& b = vertices[i];
+        const Point& c = vertices[next[i]];
+        return 0.5 * std::abs((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x));
+    };
+    typedef std::tuple<double, size_t, size_t> Entry;  // area, vertex, version
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+    for (size_t i = 0; i < n; ++i) {
+        heap.emplace(effective_area(i), i, 0);
+    }
+    std::vector<char> removed(n, 0);
+    size_t left = n;
+    while ((left > 3) and !heap.empty()) {
+        auto [area, i, ver] = heap.top();
+        heap.pop();
+        if (removed[i] or (ver != version[i])) {
+            continue;
+        }
+        if (area >= min_area) {
+            break;
+        }
+        removed[i] = 1;
+        --left;
+        next[prev[i]] = next[i];
+        prev[next[i]] = prev[i];
+        for (size_t j : {prev[i], next[i]}) {
+            heap.emplace(effective_area(j), j, ++version[j]);
+        }
+    }
+    std::vector<Point> res;
+    for (size_t i = 0; i < n; ++i) {
+        if (!removed[i]) {
+            res.push_back(vertices[i]);
+        }
+    }
+    return Polygon(res);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+
+#include "geometry.h"
+
+
+const double kSinCosReduceLimit = 1e6;  // larger angles lose precision in the two-part reduction, std:: is used
+
+// Sine and cosine of many angles (radians) at once: reduction by pi / 2 in two parts, the cephes polynomials on
+// [-pi / 4, pi / 4] and quadrant selection without branches or std::floor, so the main loop vectorizes (-O3 -march=native).
+// Within a few ulp of std::sin / std::cos.
+void batchSinCos(const double* angles, size_t count, double* sines, double* cosines) {
+    const double kTwoOverPi = 0.636619772367581343076;
+    const double kPiOverTwoHigh = 1.57079632673412561417;  // 33 bits, j * high is exact for |j| < 2^20
+    const double kPiOverTwoLow = 6.07710050650619224932e-11;
+    const double kRoundMagic = 6755399441055744.0;  // 1.5 * 2^52, adding it rounds to an integer
+    for (size_t i = 0; i < count; ++i) {
+        double x = angles[i];
+        double j = (x * kTwoOverPi + kRoundMagic) - kRoundMagic;
+        double r = (x - j * kPiOverTwoHigh) - j * kPiOverTwoLow;
+        double z = r * r;
+        double s = r + r * z * (((((1.58962301576546568060e-10 * z - 2.50507477628578072866e-8) * z +
+                                    2.75573136213857245213e-6) * z - 1.98412698295895385996e-4) * z +
+                                  8.33333333332211858878e-3) * z - 1.66666666666666307295e-1);
+        double c = 1.0 - 0.5 * z + z * z * (((((-1.13585365213876817300e-11 * z + 2.08757008419747316778e-9) * z -
+                                               2.75573141792967388112e-7) * z + 2.48015872888517045348e-5) * z -
+                                             1.38888888888730564116e-3) * z + 4.16666666666665929218e-2);
+        double half = ((j * 0.5 - 0.25) + kRoundMagic) - kRoundMagic;  // floor(j / 2); std::floor blocks vectorization
+        double odd = j - 2 * half;  // bit 0 of the quadrant: sine and cosine swap
+        double upper = half - 2 * (((half * 0.5 - 0.25) + kRoundMagic) - kRoundMagic);  // bit 1: sine changes sign
+        double sin_x = (odd != 0) ? c : s;
+        double cos_x = (odd != 0) ? s : c;
+        sines[i] = (upper != 0) ? -sin_x : sin_x;
+        cosines[i] = (odd != upper) ? -cos_x : cos_x;
+    }
+    for (size_t i = 0; i < count; ++i) {  // rare fix-up pass, kept out of the vectorized loop
+        if (!(std::abs(angles[i]) <= kSinCosReduceLimit)) {
+            sines[i] = std::sin(angles[i]);
+            cosines[i] = std::cos(angles[i]);
+        }
+    }
+}
+
+
+std::vector<Rotation> batchRotations(const std::vector<double>& angles) {  // angles in degrees, counterclockwise
+    size_t n = angles.size();
+    std::vector<double> radians(n), sines(n), cosines(n);
+    for (size_t i = 0; i < n; ++i) {
+        radians[i] = angles[i] * M_PI / 180;
+    }
+    batchSinCos(radians.data(), n, sines.data(), cosines.data());
+    std::vector<Rotation> res(n);
+    for (size_t i = 0; i < n; ++i) {
+        res[i] = Rotation{cosines[i], sines[i]};
+    }
+    return res;
+}
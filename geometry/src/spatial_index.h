@@ -0,0 +1,299 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <memory>
+#include <utility>
+#include <cmath>
+#include <algorithm>
+
+#include "geometry.h"
+
+
+class ShapeIndex {  // R-tree over shape bounding boxes, shapes are not owned
+public:
+    ShapeIndex() : root(new Node(true)), count(0) {}
+
+    explicit ShapeIndex(const std::vector<Shape*>& shapes) : count(shapes.size()) {  // STR bulk load
+        std::vector<std::unique_ptr<Node>> level;
+        std::vector<Entry> entries;
+        entries.reserve(shapes.size());
+        for (auto shape : shapes) {
+            entries.push_back({shape->boundingBox(), shape});
+        }
+        packTiles(entries, [&](std::vector<Entry>::iterator begin, std::vector<Entry>::iterator end) {
+            std::unique_ptr<Node> leaf(new Node(true));
+            leaf->entries.assign(begin, end);
+            leaf->updateBox();
+            level.push_back(std::move(leaf));
+        });
+        while (level.size() > 1) {
+            std::vector<std::unique_ptr<Node>> parents;
+            packTiles(level, [&](std::vector<std::unique_ptr<Node>>::iterator begin,
+                                 std::vector<std::unique_ptr<Node>>::iterator end) {
+                std::unique_ptr<Node> node(new Node(false));
+                for (auto it = begin; it != end; ++it) {
+                    node->children.push_back(std::move(*it));
+                }
+                node->updateBox();
+                parents.push_back(std::move(node));
+            });
+            level = std::move(parents);
+        }
+        this->root = level.empty() ? std::unique_ptr<Node>(new Node(true)) : std::move(level[0]);
+    }
+
+    size_t size() const {
+        return this->count;
+    }
+
+    void insert(Shape* shape) {
+        Entry entry{shape->boundingBox(), shape};
+        std::unique_ptr<Node> sibling = insertInto(this->root.get(), entry);
+        if (sibling) {  // root was split, grow the tree by one level
+            std::unique_ptr<Node> new_root(new Node(false));
+            new_root->children.push_back(std::move(this->root));
+            new_root->children.push_back(std::move(sibling));
+            new_root->updateBox();
+            this->root = std::move(new_root);
+        }
+        ++this->count;
+    }
+
+    bool remove(Shape* shape) {  // looks under the current box first, then falls back to a full scan
+        BoundingBox box = shape->boundingBox();
+        if (!removeFrom(this->root.get(), shape, &box) and !removeFrom(this->root.get(), shape, nullptr)) {
+            return false;
+        }
+        while (!this->root->leaf and this->root->children.size() == 1) {
+            std::unique_ptr<Node> child = std::move(this->root->children[0]);
+            this->root = std::move(child);
+        }
+        if (!this->root->leaf and this->root->children.empty()) {
+            this->root.reset(new Node(true));
+        }
+        --this->count;
+        return true;
+    }
+
+    std::vector<Shape*> queryPoint(const Point& p) const {  // shapes whose bounding box contains p
+        std::vector<Shape*> res;
+        queryPointFrom(this->root.get(), p, res);
+        return res;
+    }
+
+    std::vector<Shape*> queryContaining(const Point& p) const {  // box candidates filtered by containsPoint
+        std::vector<Shape*> res = this->queryPoint(p);
+        res.erase(std::remove_if(res.begin(), res.end(), [&p](Shape* shape) {
+            return !shape->containsPoint(p);
+        }), res.end());
+        return res;
+    }
+
+    std::vector<Shape*> queryBox(const BoundingBox& box) const {  // shapes whose bounding box intersects box
+        std::vector<Shape*> res;
+        queryBoxFrom(this->root.get(), box, res);
+        return res;
+    }
+
+    std::vector<Shape*> nearest(const Point& p, size_t k) const {  // k closest bounding boxes, best-first search
+        typedef std::pair<double, std::pair<const Node*, Shape*>> Item;
+        std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+        queue.push({this->root->box.sqrDistance(p), {this->root.get(), nullptr}});
+        std::vector<Shape*> res;
+        while (!queue.empty() and res.size() < k) {
+            Item item = queue.top();
+            queue.pop();
+            const Node* node = item.second.first;
+            if (node == nullptr) {
+                res.push_back(item.second.second);
+                continue;
+            }
+            if (node->leaf) {
+                for (const auto& entry : node->entries) {
+                    queue.push({entry.box.sqrDistance(p), {nullptr, entry.shape}});
+                }
+            } else {
+                for (const auto& child : node->children) {
+                    queue.push({child->box.sqrDistance(p), {child.get(), nullptr}});
+                }
+            }
+        }
+        return res;
+    }
+
+private:
+    static const size_t kMaxEntries = 16;
+
+    struct Entry {
+        BoundingBox box;
+        Shape* shape;
+    };
+
+    struct Node {
+        explicit Node(bool leaf) : leaf(leaf) {}
+
+        size_t size() const {
+            return this->leaf ? this->entries.size() : this->children.size();
+        }
+
+        void updateBox() {
+            this->box = BoundingBox();
+            for (const auto& entry : this->entries) {
+                this->box.extend(entry.box);
+            }
+            for (const auto& child : this->children) {
+                this->box.extend(child->box);
+            }
+        }
+
+        BoundingBox box;
+        bool leaf;
+        std::vector<Entry> entries;  // leaf only
+        std::vector<std::unique_ptr<Node>> children;  // inner only
+    };
+
+    static const BoundingBox& boxOf(const Entry& entry) {
+        return entry.box;
+    }
+
+    static const BoundingBox& boxOf(const std::unique_ptr<Node>& node) {
+        return node->box;
+    }
+
+    // Sort-Tile-Recursive: sqrt(P) vertical slices by center x, each packed by center y
+    template <class T, class Emit>
+    static void packTiles(std::vector<T>& items, Emit emit) {
+        size_t pages = (items.size() + kMaxEntries - 1) / kMaxEntries;
+        size_t slices = static_cast<size_t>(ceil(sqrt(static_cast<double>(pages))));
+        size_t slice_size = slices * kMaxEntries;
+        std::sort(items.begin(), items.end(), [](const T& lhs, const T& rhs) {
+            return boxOf(lhs).center().x < boxOf(rhs).center().x;
+        });
+        for (size_t begin = 0; begin < items.size(); begin += slice_size) {
+            size_t end = std::min(begin + slice_size, items.size());
+            std::sort(items.begin() + begin, items.begin() + end, [](const T& lhs, const T& rhs) {
+                return boxOf(lhs).center().y < boxOf(rhs).center().y;
+            });
+            for (size_t i = begin; i < end; i += kMaxEntries) {
+                emit(items.begin() + i, items.begin() + std::min(i + kMaxEntries, end));
+            }
+        }
+    }
+
+    template <class T>
+    static std::vector<T> splitHalf(std::vector<T>& items) {  // keeps one half, returns the other
+        BoundingBox box;
+        for (const auto& item : items) {
+            box.extend(boxOf(item));
+        }
+        bool by_x = box.max.x - box.min.x >= box.max.y - box.min.y;
+        std::sort(items.begin(), items.end(), [by_x](const T& lhs, const T& rhs) {
+            return by_x ? boxOf(lhs).center().x < boxOf(rhs).center().x
+                        : boxOf(lhs).center().y < boxOf(rhs).center().y;
+        });
+        std::vector<T> other;
+        for (size_t i = items.size() / 2; i < items.size(); ++i) {
+            other.push_back(std::move(items[i]));
+        }
+        items.resize(items.size() / 2);
+        return other;
+    }
+
+    static double enlargement(const BoundingBox& box, const BoundingBox& add) {
+        BoundingBox res = box;
+        res.extend(add);
+        return res.area() - box.area();
+    }
+
+    std::unique_ptr<Node> insertInto(Node* node, const Entry& entry) {  // returns a new sibling on split
+        if (node->leaf) {
+            node->entries.push_back(entry);
+        } else {
+            size_t best = 0;
+            for (size_t i = 1; i < node->children.size(); ++i) {  // least enlargement, then smallest area
+                double lhs = enlargement(node->children[i]->box, entry.box);
+                double rhs = enlargement(node->children[best]->box, entry.box);
+                if (lhs < rhs or (lhs == rhs and node->children[i]->box.area() < node->children[best]->box.area())) {
+                    best = i;
+                }
+            }
+            std::unique_ptr<Node> sibling = insertInto(node->children[best].get(), entry);
+            if (sibling) {
+                node->children.push_back(std::move(sibling));
+            }
+        }
+        if (node->size() <= kMaxEntries) {
+            node->box.extend(entry.box);
+            return nullptr;
+        }
+        std::unique_ptr<Node> sibling(new Node(node->leaf));
+        if (node->leaf) {
+            sibling->entries = splitHalf(node->entries);
+        } else {
+            sibling->children = splitHalf(node->children);
+        }
+        node->updateBox();
+        sibling->updateBox();
+        return sibling;
+    }
+
+    bool removeFrom(Node* node, Shape* shape, const BoundingBox* box) {
+        if (box != nullptr and !node->box.intersects(*box)) {
+            return false;
+        }
+        bool found = false;
+        if (node->leaf) {
+            for (size_t i = 0; i < node->entries.size() and !found; ++i) {
+                if (node->entries[i].shape == shape) {
+                    node->entries.erase(node->entries.begin() + i);
+                    found = true;
+                }
+            }
+        } else {
+            for (size_t i = 0; i < node->children.size() and !found; ++i) {
+                if (removeFrom(node->children[i].get(), shape, box)) {
+                    if (node->children[i]->size() == 0) {  // drop emptied subtrees
+                        node->children.erase(node->children.begin() + i);
+                    }
+                    found = true;
+                }
+            }
+        }
+        if (found) {
+            node->updateBox();
+        }
+        return found;
+    }
+
+    static void queryPointFrom(const Node* node, const Point& p, std::vector<Shape*>& res) {
+        if (!node->box.contains(p)) {
+            return;
+        }
+        for (const auto& entry : node->entries) {
+            if (entry.box.contains(p)) {
+                res.push_back(entry.shape);
+            }
+        }
+        for (const auto& child : node->children) {
+            queryPointFrom(child.get(), p, res);
+        }
+    }
+
+    static void queryBoxFrom(const Node* node, const BoundingBox& box, std::vector<Shape*>& res) {
+        if (!node->box.intersects(box)) {
+            return;
+        }
+        for (const auto& entry : node->entries) {
+            if (entry.box.intersects(box)) {
+                res.push_back(entry.shape);
+            }
+        }
+        for (const auto& child : node->children) {
+            queryBoxFrom(child.get(), box, res);
+        }
+    }
+
+    std::unique_ptr<Node> root;
+    size_t count;
+};
@@ -0,0 +1,460 @@
+#pragma once
+
+#include <vector>
+#include <set>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+
+#include "geometry.h"
+
+
+// Triangulations of a simple polygon as index buffers: three vertex indices per triangle, counterclockwise.
+
+std::vector<size_t> counterclockwiseOrder(const std::vector<Point>& vertices) {
+    std::vector<size_t> order(vertices.size());
+    std::iota(order.begin(), order.end(), 0);
+    if (polygonOrientation(vertices) < 0) {
+        std::reverse(order.begin(), order.end());
+    }
+    return order;
+}
+
+
+void pushTriangle(std::vector<size_t>& indices, const std::vector<Point>& vertices, size_t a, size_t b, size_t c) {
+    if (orientation(vertices[a], vertices[b], vertices[c]) < 0) {
+        std::swap(b, c);
+    }
+    indices.push_back(a);
+    indices.push_back(b);
+    indices.push_back(c);
+}
+
+
+bool insideTriangle(const Point& p, const Point& a, const Point& b, const Point& c) {  // a, b, c counterclockwise
+    return (orientation(a, b, p) >= 0) and (orientation(b, c, p) >= 0) and (orientation(c, a, p) >= 0);
+}
+
+
+// Ear clipping, O(n^2): cuts off convex vertices whose triangle holds no reflex vertex.
+std::vector<size_t> earClippingIndices(const Polygon& polygon) {
+    const auto& vertices = polygon.getVertices();
+    std::vector<size_t> ring = counterclockwiseOrder(vertices);
+    std::vector<size_t> indices;
+    if (ring.size() < 3) {
+        return indices;
+    }
+    indices.reserve(3 * (ring.size() - 2));
+    auto is_ear = [&](size_t k) {
+        size_t n = ring.size();
+        const Point& a = vertices[ring[(k + n - 1) % n]];
+        const Point& b = vertices[ring[k]];
+        const Point& c = vertices[ring[(k + 1) % n]];
+        if (orientation(a, b, c) <= 0) {
+            return false;
+        }
+        for (size_t m = 0; m < n; ++m) {
+            const Point& p = vertices[ring[m]];
+            if ((m == k) or (m == (k + 1) % n) or (m == (k + n - 1) % n) or (p == a) or (p == b) or (p == c)) {
+                continue;
+            }
+            if ((orientation(vertices[ring[(m + n - 1) % n]], p, vertices[ring[(m + 1) % n]]) <= 0) and
+                insideTriangle(p, a, b, c)) {
+                return false;
+            }
+        }
+        return true;
+    };
+    size_t k = 0, misses = 0;
+    while (ring.size() > 3) {
+        size_t n = ring.size();
+        k %= n;
+        if (is_ear(k) or (misses >= n)) {  // a degenerate ring without ears is cut anyway
+            pushTriangle(indices, vertices, ring[(k + n - 1) % n], ring[k], ring[(k + 1) % n]);
+            ring.erase(ring.begin() + k);
+            k = (k + n - 2) % (n - 1);
+            misses = 0;
+        } else {
+            ++k;
+            ++misses;
+        }
+    }
+    pushTriangle(indices, vertices, ring[0], ring[1], ring[2]);
+    return indices;
+}
+
+
+// O(n log n): a sweep from top to bottom adds diagonals at split and merge vertices (de Berg et al., ch. 3),
+// the resulting y-monotone faces are triangulated with a stack in linear time each.
+class MonotoneTriangulator {
+public:
+    explicit MonotoneTriangulator(const Polygon& polygon)
+            : order(counterclockwiseOrder(polygon.getVertices())), status(EdgeLess{this}) {
+        for (size_t i : this->order) {
+            this->vertices.push_back(polygon.getVertices()[i]);
+        }
+    }
+
+    std::vector<size_t> indices() {
+        std::vector<size_t> res;
+        size_t n = this->vertices.size();
+        if (n < 3) {
+            return res;
+        }
+        res.reserve(3 * (n - 2));
+        this->partition();
+        std::sort(this->diagonals.begin(), this->diagonals.end());
+        this->diagonals.erase(std::unique(this->diagonals.begin(), this->diagonals.end()), this->diagonals.end());
+        for (const auto& face : this->faces()) {
+            this->triangulateMonotone(face, res);
+        }
+        for (auto& index : res) {  // back to the numbering of the input polygon
+            index = this->order[index];
+        }
+        return res;
+    }
+
+private:
+    enum VertexKind { Start, End, Split, Merge, Regular };
+
+    struct EdgeLess {  // edges crossing the sweep line, left to right
+        const MonotoneTriangulator* triangulator;
+
+        bool operator()(size_t lhs, size_t rhs) const {
+            double lx = this->triangulator->xAt(lhs), rx = this->triangulator->xAt(rhs);
+            return (lx != rx) ? (lx < rx) : (lhs < rhs);
+        }
+    };
+
+    static bool above(const Point& p, const Point& q) {  // sweep order: higher first, then left to right
+        return (p.y > q.y) or ((p.y == q.y) and (p.x < q.x));
+    }
+
+    size_t next(size_t i) const {
+        return (i + 1) % this->vertices.size();
+    }
+
+    size_t prev(size_t i) const {
+        return (i + this->vertices.size() - 1) % this->vertices.size();
+    }
+
+    double xAt(size_t edge) const {  // edge i runs from vertex i to vertex i + 1; index n is a probe at the sweep
+        if (edge == this->vertices.size()) {
+            return this->sweep.x;
+        }
+        const Point& a = this->vertices[edge];
+        const Point& b = this->vertices[this->next(edge)];
+        if (a.y == b.y) {
+            return std::min(a.x, b.x);
+        }
+        return a.x + (this->sweep.y - a.y) * (b.x - a.x) / (b.y - a.y);
+    }
+
+    VertexKind kind(size_t i) const {
+        const Point& p = this->vertices[this->prev(i)];
+        const Point& v = this->vertices[i];
+        const Point& q = this->vertices[this->next(i)];
+        bool convex = orientation(p, v, q) > 0;
+        if (above(v, p) and above(v, q)) {
+            return convex ? Start : Split;
+        }
+        if (above(p, v) and above(q, v)) {
+            return convex ? End : Merge;
+        }
+        return Regular;
+    }
+
+    size_t leftEdge() const {  // edge of the status directly to the left of the sweep point
+        auto it = this->status.lower_bound(this->vertices.size());
+        return *std::prev(it);
+    }
+
+    void addDiagonal(size_t u, size_t w) {
+        this->diagonals.emplace_back(std::min(u, w), std::max(u, w));
+    }
+
+    void fixHelper(size_t edge, size_t i) {  // a diagonal to the helper if it is a merge vertex
+        if (this->kinds[this->helper[edge]] == Merge) {
+            this->addDiagonal(i, this->helper[edge]);
+        }
+    }
+
+    void partition() {
+        size_t n = this->vertices.size();
+        this->kinds.resize(n);
+        this->helper.assign(n, 0);
+        this->positions.resize(n);
+        std::vector<size_t> events(n);
+        for (size_t i = 0; i < n; ++i) {
+            this->kinds[i] = this->kind(i);
+            events[i] = i;
+        }
+        std::sort(events.begin(), events.end(), [this](size_t lhs, size_t rhs) {
+            return above(this->vertices[lhs], this->vertices[rhs]);
+        });
+        for (size_t i : events) {
+            this->sweep = this->vertices[i];
+            size_t e = this->prev(i);  // edge ending at vertex i
+            switch (this->kinds[i]) {
+                case Start:
+                    this->insert(i, i);
+                    break;
+                case End:
+                    this->fixHelper(e, i);
+                    this->status.erase(this->positions[e]);
+                    break;
+                case Split: {
+                    size_t left = this->leftEdge();
+                    this->addDiagonal(i, this->helper[left]);
+                    this->helper[left] = i;
+                    this->insert(i, i);
+                    break;
+                }
+                case Merge: {
+                    this->fixHelper(e, i);
+                    this->status.erase(this->positions[e]);
+                    size_t left = this->leftEdge();
+                    this->fixHelper(left, i);
+                    this->helper[left] = i;
+                    break;
+                }
+                case Regular:
+                    if (above(this->vertices[e], this->vertices[i])) {  // on the left chain, interior to the right
+                        this->fixHelper(e, i);
+                        this->status.erase(this->positions[e]);
+                        this->insert(i, i);
+                    } else {
+                        size_t left = this->leftEdge();
+                        this->fixHelper(left, i);
+                        this->helper[left] = i;
+                    }
+                    break;
+            }
+        }
+    }
+
+    void insert(size_t edge, size_t helper) {
+        this->positions[edge] = this->status.insert(edge).first;
+        this->helper[edge] = helper;
+    }
+
+    // boundary cycles of the subdivision by the diagonals: at each vertex turn to the next neighbour clockwise
+    std::vector<std::vector<size_t>> faces() const {
+        size_t n = this->vertices.size();
+        std::vector<std::vector<size_t>> adjacent(n);
+        for (size_t i = 0; i < n; ++i) {
+            adjacent[i].push_back(this->next(i));
+            adjacent[i].push_back(this->prev(i));
+        }
+        for (const auto& [u, w] : this->diagonals) {
+            adjacent[u].push_back(w);
+            adjacent[w].push_back(u);
+        }
+        for (size_t i = 0; i < n; ++i) {  // counterclockwise by angle
+            const Point& c = this->vertices[i];
+            std::sort(adjacent[i].begin(), adjacent[i].end(), [&](size_t lhs, size_t rhs) {
+                return atan2(this->vertices[lhs].y - c.y, this->vertices[lhs].x - c.x) <
+                       atan2(this->vertices[rhs].y - c.y, this->vertices[rhs].x - c.x);
+            });
+        }
+        std::vector<std::vector<char>> used(n);
+        for (size_t i = 0; i < n; ++i) {  // edges to the previous vertex bound the outside
+            used[i].resize(adjacent[i].size());
+            for (size_t k = 0; k < adjacent[i].size(); ++k) {
+                used[i][k] = adjacent[i][k] == this->prev(i);
+            }
+        }
+        std::vector<std::vector<size_t>> res;
+        for (size_t start = 0; start < n; ++start) {
+            for (size_t k = 0; k < adjacent[start].size(); ++k) {
+                if (used[start][k]) {
+                    continue;
+                }
+                std::vector<size_t> face;
+                size_t u = start, slot = k;
+                while (!used[u][slot]) {
+                    used[u][slot] = 1;
+                    face.push_back(u);
+                    size_t w = adjacent[u][slot];
+                    const auto& around = adjacent[w];
+                    size_t back = std::find(around.begin(), around.end(), u) - around.begin();
+                    slot = (back + around.size() - 1) % around.size();  // next clockwise after the way back
+                    u = w;
+                }
+                res.push_back(face);
+            }
+        }
+        return res;
+    }
+
+    // stack algorithm for a y-monotone counterclockwise face
+    void triangulateMonotone(const std::vector<size_t>& face, std::vector<size_t>& res) const {
+        size_t k = face.size();
+        if (k < 3) {
+            return;
+        }
+        size_t top = 0, bottom = 0;
+        for (size_t i = 1; i < k; ++i) {
+            if (above(this->vertices[face[i]], this->vertices[face[top]])) {
+                top = i;
+            }
+            if (above(this->vertices[face[bottom]], this->vertices[face[i]])) {
+                bottom = i;
+            }
+        }
+        std::vector<char> left(k, 0);  // counterclockwise from the top down to the bottom is the left chain
+        for (size_t i = top; i != bottom; i = (i + 1) % k) {
+            left[i] = 1;
+        }
+        std::vector<size_t> sorted = {top};  // merge of both chains from the top
+        sorted.reserve(k);
+        size_t l = (top + 1) % k, r = (top + k - 1) % k;
+        while ((l != bottom) or (r != bottom)) {
+            if ((r == bottom) or ((l != bottom) and above(this->vertices[face[l]], this->vertices[face[r]]))) {
+                sorted.push_back(l);
+                l = (l + 1) % k;
+            } else {
+                sorted.push_back(r);
+                r = (r + k - 1) % k;
+            }
+        }
+        sorted.push_back(bottom);
+        auto point = [&](size_t i) -> const Point& {
+            return this->vertices[face[i]];
+        };
+        std::vector<size_t> stack = {sorted[0], sorted[1]};
+        for (size_t j = 2; j + 1 < k; ++j) {
+            size_t u = sorted[j];
+            if (left[u] != left[stack.back()]) {
+                while (stack.size() > 1) {
+                    size_t w = stack.back();
+                    stack.pop_back();
+                    pushTriangle(res, this->vertices, face[u], face[w], face[stack.back()]);
+                }
+                stack.pop_back();
+                stack.push_back(sorted[j - 1]);
+                stack.push_back(u);
+            } else {
+                size_t last = stack.back();
+                stack.pop_back();
+                while (!stack.empty()) {
+                    double turn = orientation(point(stack.back()), point(last), point(u));
+                    if (left[u] ? (turn <= 0) : (turn >= 0)) {
+                        break;
+                    }
+                    pushTriangle(res, this->vertices, face[u], face[last], face[stack.back()]);
+                    last = stack.back();
+                    stack.pop_back();
+                }
+                stack.push_back(last);
+                stack.push_back(u);
+            }
+        }
+        size_t u = sorted[k - 1];
+        for (size_t i = stack.size() - 1; i > 0; --i) {
+            pushTriangle(res, this->vertices, face[u], face[stack[i]], face[stack[i - 1]]);
+        }
+    }
+
+    std::vector<size_t> order;  // counterclockwise position -> input index
+    std::vector<Point> vertices;
+    std::vector<VertexKind> kinds;
+    std::vector<size_t> helper;
+    std::vector<std::set<size_t, EdgeLess>::iterator> positions;
+    std::vector<std::pair<size_t, size_t>> diagonals;
+    std::set<size_t, EdgeLess> status;
+    Point sweep;
+};
+
+
+std::vector<size_t> monotoneIndices(const Polygon& polygon) {
+    return MonotoneTriangulator(polygon).indices();
+}
+
+
+const size_t kEarClippingLimit = 128;  // ear clipping wins on small polygons, see bench/bench.cpp
+
+std::vector<size_t> triangulationIndices(const Polygon& polygon) {
+    if (polygon.verticesCount() <= kEarClippingLimit) {
+        return earClippingIndices(polygon);
+    }
+    return monotoneIndices(polygon);
+}
+
+
+std::vector<Triangle> triangulate(const Polygon& polygon) {
+    const auto& vertices = polygon.getVertices();
+    std::vector<size_t> indices = triangulationIndices(polygon);
+    std::vector<Triangle> res;
+    res.reserve(indices.size() / 3);
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        res.emplace_back(vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]]);
+    }
+    return res;
+}
+
+
+// Vertices plus an index buffer; area, centroid and containment run over flat triangle arrays
+class TriangleMesh {
+public:
+    explicit TriangleMesh(const Polygon& polygon)
+            : vertices(polygon.getVertices()), indices(triangulationIndices(polygon)) {}
+
+    TriangleMesh(std::vector<Point> vertices, std::vector<size_t> indices)
+            : vertices(std::move(vertices)), indices(std::move(indices)) {}
+
+    size_t trianglesCount() const {
+        return this->indices.size() / 3;
+    }
+
+    const std::vector<Point>& getVertices() const {
+        return this->vertices;
+    }
+
+    const std::vector<size_t>& getIndices() const {
+        return this->indices;
+    }
+
+    Triangle triangle(size_t i) const {
+        return Triangle(this->corner(i, 0), this->corner(i, 1), this->corner(i, 2));
+    }
+
+    double area() const {
+        double res = 0;
+        for (size_t i = 0; i < this->trianglesCount(); ++i) {
+            res += 0.5 * std::abs(cross(this->corner(i, 0), this->corner(i, 1), this->corner(i, 2)));
+        }
+        return res;
+    }
+
+    Point centroid() const {  // area-weighted centroids of the triangles
+        double sum = 0, x = 0, y = 0;
+        for (size_t i = 0; i < this->trianglesCount(); ++i) {
+            const Point& a = this->corner(i, 0);
+            const Point& b = this->corner(i, 1);
+            const Point& c = this->corner(i, 2);
+            double w = std::abs(cross(a, b, c));
+            sum += w;
+            x += w * (a.x + b.x + c.x);
+            y += w * (a.y + b.y + c.y);
+        }
+        return sum > 0 ? Point(x / (3 * sum), y / (3 * sum)) : Point();
+    }
+
+    bool containsPoint(const Point& p) const {
+        for (size_t i = 0; i < this->trianglesCount(); ++i) {
+            if (insideTriangle(p, this->corner(i, 0), this->corner(i, 1), this->corner(i, 2))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    const Point& corner(size_t triangle, size_t k) const {
+        return this->vertices[this->indices[3 * triangle + k]];
+    }
+
+    std::vector<Point> vertices;
+    std::vector<size_t> indices;
+};
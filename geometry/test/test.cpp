@@ -1,10 +1,28 @@
 #include "geometry.h"
+#include "spatial_index.h"
+#include "polygon_soa.h"
+#include "shape_store.h"
+#include "congruence.h"
+#include "convex_hull.h"
+#include "simplification.h"
+#include "intersection.h"
+#include "triangulation.h"
+#include "sincos.h"
+#include "point_index.h"
+#include "shape_io.h"
+#include "scene.h"
+#include "compact.h"
+#include "polygon_arena.h"
 
 #include <cmath>
 #include <vector>
+#include <memory>
 #include <sstream>
+#include <fstream>
 #include <iostream>
 #include <algorithm>
+#include <random>
+#include <unordered_set>
 
 
 double distance(const Point& a, const Point& b) {
@@ -15,6 +33,14 @@ bool equals(double a, double b, double eps = 1e-6) {
     return a-b <= eps && b-a <= eps;
 }
 
+Polygon RegularPolygonForTest(size_t n, const Point& center, double radius = 2) {
+    std::vector<Point> vertices;
+    for (size_t i = 0; i < n; ++i) {
+        vertices.emplace_back(center.x + radius * cos(2 * M_PI * i / n), center.y + radius * sin(2 * M_PI * i / n));
+    }
+    return Polygon(vertices);
+}
+
 int main() {
 
     const int ax = -2, ay = 2, bx = 1, by = 2,
@@ -185,5 +211,983 @@ int main() {
         }
     }
 
+    // Spatial index testing
+    {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<double> coord(-100, 100), size(0.5, 5);
+        std::vector<Polygon> polygons;
+        std::vector<Circle> circles;
+        for (int i = 0; i < 500; ++i) {
+            Point p(coord(gen), coord(gen));
+            double w = size(gen), h = size(gen);
+            polygons.push_back(Polygon({p, Point(p.x + w, p.y), Point(p.x + w, p.y + h)}));
+            circles.push_back(Circle(Point(coord(gen), coord(gen)), size(gen)));
+        }
+        std::vector<Shape*> scene;
+        for (int i = 0; i < 500; ++i) {
+            scene.push_back(&polygons[i]);
+            scene.push_back(&circles[i]);
+        }
+
+        auto bruteForce = [&](const BoundingBox& box) {
+            std::vector<Shape*> res;
+            for (auto shape : scene) {
+                if (shape->boundingBox().intersects(box)) {
+                    res.push_back(shape);
+                }
+            }
+            std::sort(res.begin(), res.end());
+            return res;
+        };
+
+        ShapeIndex bulk(scene);
+        ShapeIndex incremental;
+        for (auto shape : scene) {
+            incremental.insert(shape);
+        }
+        for (int i = 0; i < 100; ++i) {
+            Point p(coord(gen), coord(gen));
+            BoundingBox box(p, Point(p.x + 10 * size(gen), p.y + 10 * size(gen)));
+            auto expected = bruteForce(box);
+            auto found = bulk.queryBox(box);
+            auto found2 = incremental.queryBox(box);
+            std::sort(found.begin(), found.end());
+            std::sort(found2.begin(), found2.end());
+            if (found != expected or found2 != expected) {
+                std::cerr << "Test 11.0 failed. (spatial index box query)\n";
+                return 1;
+            }
+            auto at_point = bulk.queryPoint(p);
+            std::sort(at_point.begin(), at_point.end());
+            if (at_point != bruteForce(BoundingBox(p, p))) {
+                std::cerr << "Test 11.1 failed. (spatial index point query)\n";
+                return 1;
+            }
+            auto near = bulk.nearest(p, 5);
+            std::vector<double> dists;
+            for (auto shape : scene) {
+                dists.push_back(shape->boundingBox().sqrDistance(p));
+            }
+            std::sort(dists.begin(), dists.end());
+            if (near.size() != 5 or !equals(near.back()->boundingBox().sqrDistance(p), dists[4])) {
+                std::cerr << "Test 11.2 failed. (spatial index nearest query)\n";
+                return 1;
+            }
+        }
+        for (int i = 0; i < 500; ++i) {
+            if (!bulk.remove(scene[2 * i]) or !incremental.remove(scene[2 * i])) {
+                std::cerr << "Test 11.3 failed. (spatial index remove)\n";
+                return 1;
+            }
+        }
+        if (bulk.size() != 500 or bulk.queryBox(BoundingBox(Point(-200, -200), Point(200, 200))).size() != 500 or
+            incremental.remove(scene[0])) {
+            std::cerr << "Test 11.3 failed. (spatial index remove)\n";
+            return 1;
+        }
+    }
+
+    // Containment testing
+    {
+        std::mt19937 gen(7);
+        std::uniform_real_distribution<double> coord(-10, 10);
+        std::vector<Point> points;
+        for (int i = 0; i < 2000; ++i) {
+            points.push_back(Point(coord(gen), coord(gen)));
+        }
+        Point p1(-3, -2), p2(4, 1), p3(0, 6);
+        Triangle triangle(p1, p2, p3);
+        Rectangle rectangle(Point(-5, -4), Point(6, 3), 0.5);
+        Polygon star({Point(0, 8), Point(2, 2), Point(8, 0), Point(2, -2), Point(0, -8),
+                      Point(-2, -2), Point(-8, 0), Point(-2, 2)});
+        Circle circle(Point(1, 1), 4);
+        Ellipse circle_as_ellipse(Point(1, 1), Point(1, 1), 8);
+        Polygon triangle_as_polygon(triangle.getVertices());
+        Polygon rectangle_as_polygon(rectangle.getVertices());
+        std::vector<std::pair<const Shape*, const Shape*>> pairs = {
+            {&triangle, &triangle_as_polygon},
+            {&rectangle, &rectangle_as_polygon},
+            {&star, &star},
+            {&circle, &circle_as_ellipse}};
+        for (auto& pair : pairs) {
+            auto batch = pair.first->containsPoints(points);
+            auto reference = pair.second->containsPoints(points);
+            for (size_t i = 0; i < points.size(); ++i) {
+                if (batch[i] != pair.first->containsPoint(points[i]) or batch[i] != reference[i]) {
+                    std::cerr << "Test 12.0 failed. (containsPoint)\n";
+                    return 1;
+                }
+            }
+        }
+        if (!star.containsPoint(Point(1, 1)) or star.containsPoint(Point(4, 4)) or !star.containsPoint(Point(5, 0)) or
+            !star.containsPoint(Point(8, 0)) or !triangle.containsPoint(p3) or !circle.containsPoint(Point(5, 1))) {
+            std::cerr << "Test 12.1 failed. (containsPoint)\n";
+            return 1;
+        }
+        const auto& corners = rectangle.getVertices();  // initPoints: a real rectangle with the given side ratio
+        double side1 = distance(corners[0], corners[1]), side2 = distance(corners[1], corners[2]);
+        for (size_t i = 0; i < 4; ++i) {
+            const Point& o = corners[i];
+            const Point& u = corners[(i + 1) % 4];
+            const Point& v = corners[(i + 3) % 4];
+            if (!equals((u.x - o.x) * (v.x - o.x) + (u.y - o.y) * (v.y - o.y), 0, 1e-9)) {
+                std::cerr << "Test 12.2 failed. (rectangle corners)\n";
+                return 1;
+            }
+        }
+        if ((corners[0] != Point(-5, -4)) or (corners[2] != Point(6, 3)) or
+            !equals(std::max(side1, side2) / std::min(side1, side2), 2)) {
+            std::cerr << "Test 12.2 failed. (rectangle corners)\n";
+            return 1;
+        }
+    }
+
+    // Structure-of-arrays polygon testing
+    {
+        std::mt19937 gen(11);
+        std::uniform_real_distribution<double> angle(0, 2 * M_PI), shift(-50, 50);
+        for (size_t count : {3, 4, 7, 16, 100, 1001}) {
+            std::vector<double> angles;
+            for (size_t i = 0; i < count; ++i) {
+                angles.push_back(angle(gen));
+            }
+            std::sort(angles.begin(), angles.end());
+            double cx = shift(gen), cy = shift(gen);
+            std::vector<Point> vertices;
+            for (double t : angles) {
+                vertices.push_back(Point(cx + 20 * cos(t), cy + 20 * sin(t)));
+            }
+            Polygon polygon(vertices);
+            PolygonSoA soa(polygon);
+            if (!equals(polygon.area(), soa.area()) or !equals(polygon.perimeter(), soa.perimeter()) or
+                !equals(soa.toPolygon().area(), polygon.area())) {
+                std::cerr << "Test 13 failed. (structure-of-arrays area or perimeter)\n";
+                return 1;
+            }
+        }
+        Polygon star({Point(0, 8), Point(2, 2), Point(8, 0), Point(2, -2), Point(0, -8),  // not convex
+                      Point(-2, -2), Point(-8, 0), Point(-2, 2)});
+        if (!equals(star.area(), 64) or !equals(PolygonSoA(star).area(), 64)) {
+            std::cerr << "Test 13 failed. (area of a non-convex polygon)\n";
+            return 1;
+        }
+    }
+
+    // Affine transform testing
+    {
+        Point o(1, 2);
+        Polygon unit({Point(1, 2), Point(2, 2), Point(2, 3), Point(1, 3)});
+        Polygon rotated = unit;
+        rotated.rotate(o, 90);
+        if (rotated != Polygon({Point(1, 2), Point(1, 3), Point(0, 3), Point(0, 2)})) {
+            std::cerr << "Test 14.0 failed. (rotate by degrees)\n";
+            return 1;
+        }
+        Polygon reflected = unit;
+        reflected.reflex(Line(Point(0, 0), Point(0, 1)));  // vertical axis
+        reflected.reflex(o);
+        if (reflected != Polygon({Point(3, 2), Point(4, 2), Point(4, 1), Point(3, 1)})) {
+            std::cerr << "Test 14.1 failed. (reflex)\n";
+            return 1;
+        }
+
+        Line axis(Point(-1, 4), Point(3, -2));
+        AffineTransform combined = AffineTransform().rotate(o, 37).scale(Point(-2, 5), 1.5).reflex(axis).reflex(o);
+        Polygon sequential = unit;
+        Ellipse ellipse(Point(0, 0), Point(3, 1), 5);
+        Ellipse ellipse_sequential = ellipse;
+        for (Shape* shape : std::vector<Shape*>{&sequential, &ellipse_sequential}) {
+            shape->rotate(o, 37);
+            shape->scale(Point(-2, 5), 1.5);
+            shape->reflex(axis);
+            shape->reflex(o);
+        }
+        Polygon at_once = unit;
+        transformShapes({&at_once, &ellipse}, combined);
+        if (at_once != sequential or !(ellipse == ellipse_sequential) or !equals(at_once.area(), 2.25 * unit.area()) or
+            !equals(ellipse.eccentricity(), Ellipse(Point(0, 0), Point(3, 1), 5).eccentricity())) {
+            std::cerr << "Test 14.2 failed. (composed transform)\n";
+            return 1;
+        }
+    }
+
+    // Shape store testing
+    {
+        Point p1(0, 0), p2(4, 0), p3(1, 3);
+        ShapeStore store;
+        std::vector<Shape*> virtual_scene;
+        Polygon pentagon({Point(0, 0), Point(3, 0), Point(4, 2), Point(2, 4), Point(-1, 2)});
+        Ellipse ellipse(Point(-1, 0), Point(2, 2), 6);
+        Circle circle(Point(5, 5), 2);
+        Rectangle rectangle(Point(0, 0), Point(6, 3), 2);
+        Square square(Point(1, 1), Point(4, 5));
+        Triangle triangle(p1, p2, p3);
+        for (Shape* shape : std::vector<Shape*>{&pentagon, &ellipse, &circle, &rectangle, &square, &triangle}) {
+            virtual_scene.push_back(shape);
+        }
+        store.add(pentagon);
+        store.add(ShapeVariant(ellipse));
+        store.add(circle);
+        store.add(rectangle);
+        store.add(square);
+        store.add(triangle);
+
+        AffineTransform t = AffineTransform().rotate(Point(1, 1), 30).scale(Point(0, 2), 0.5);
+        store.transform(t);
+        transformShapes(virtual_scene, t);
+        double area = 0, perimeter = 0;
+        for (auto shape : virtual_scene) {
+            area += shape->area();
+            perimeter += shape->perimeter();
+        }
+        size_t visited = 0;
+        store.visit([&visited](const Shape&) { ++visited; });
+        if (store.size() != 6 or visited != 6 or !equals(store.totalArea(), area) or
+            !equals(store.totalPerimeter(), perimeter) or !equals(store.areas<Circle>()[0], circle.area()) or
+            !(store.get<Square>()[0] == square)) {
+            std::cerr << "Test 15 failed. (shape store)\n";
+            return 1;
+        }
+    }
+
+    // Congruence testing
+    {
+        Polygon hexagon({Point(0, 0), Point(4, 0), Point(5, 2), Point(3, 5), Point(1, 4), Point(-1, 2)});
+        std::vector<Point> shifted = hexagon.getVertices();
+        std::rotate(shifted.begin(), shifted.begin() + 2, shifted.end());
+        std::reverse(shifted.begin(), shifted.end());
+        Polygon relabeled(shifted);
+        Polygon moved = hexagon;
+        moved.rotate(Point(3, -2), 71);
+        moved.reflex(Line(Point(0, 1), Point(2, 7)));
+        Polygon scaled = moved;
+        scaled.scale(Point(1, 1), 2.5);
+        Polygon different({Point(0, 0), Point(4, 0), Point(5, 2), Point(3, 5), Point(1, 4), Point(-1, 3)});
+
+        if (!(hexagon == relabeled) or hexagon == moved or
+            PolygonCanonicalForm(hexagon) != PolygonCanonicalForm(relabeled)) {
+            std::cerr << "Test 16.0 failed. (polygon coincidence)\n";
+            return 1;
+        }
+        if (!isCongruent(hexagon, moved) or !isCongruent(relabeled, moved) or isCongruent(hexagon, scaled) or
+            isCongruent(hexagon, different)) {
+            std::cerr << "Test 16.1 failed. (polygon congruence)\n";
+            return 1;
+        }
+        if (!isSimilar(hexagon, scaled) or isSimilar(hexagon, different)) {
+            std::cerr << "Test 16.2 failed. (polygon similarity)\n";
+            return 1;
+        }
+        std::unordered_set<PolygonCanonicalForm, PolygonCanonicalFormHash> unique;
+        for (const Polygon* polygon : {&hexagon, &relabeled, &moved, &scaled, &different}) {
+            unique.insert(PolygonCanonicalForm(*polygon, PolygonEquality::Congruence, 1e-4));
+        }
+        if (unique.size() != 3) {
+            std::cerr << "Test 16.3 failed. (canonical form hashing)\n";
+            return 1;
+        }
+    }
+
+    // Convex hull testing
+    {
+        std::mt19937 gen(37);
+        std::uniform_real_distribution<double> coord(-10, 10);
+        std::vector<Point> points = {Point(-10, -10), Point(10, -10), Point(10, 10), Point(-10, 10), Point(0, 10)};
+        for (size_t i = 0; i < 200000; ++i) {
+            points.emplace_back(coord(gen), coord(gen));
+        }
+        Polygon hull = convexHull(points);
+        if (hull != Polygon({Point(-10, -10), Point(10, -10), Point(10, 10), Point(-10, 10)})) {
+            std::cerr << "Test 17.0 failed. (convex hull of a square cloud)\n";
+            return 1;
+        }
+
+        std::vector<Point> sorted = points;
+        parallelSortPoints(sorted);
+        if (!std::is_sorted(sorted.begin(), sorted.end(), lexicographicLess)) {
+            std::cerr << "Test 17.1 failed. (parallel point sort)\n";
+            return 1;
+        }
+
+        std::vector<Point> disk;
+        for (size_t i = 0; i < 5000; ++i) {
+            disk.emplace_back(coord(gen), coord(gen));
+        }
+        Polygon disk_hull = convexHull(disk);
+        auto inside = disk_hull.containsPoints(disk);
+        if (std::count(inside.begin(), inside.end(), 0) != 0 or disk_hull.area() <= 0) {
+            std::cerr << "Test 17.2 failed. (hull contains every point)\n";
+            return 1;
+        }
+
+        StreamingConvexHull streaming(512);
+        std::stringstream stream;
+        stream.precision(17);
+        for (size_t i = 0; i < disk.size(); ++i) {
+            if (i % 2 == 0) {
+                streaming.add(disk[i]);
+            } else {
+                stream << disk[i].x << ' ' << disk[i].y << '\n';
+            }
+        }
+        streaming.add(stream);
+        if (streaming.pointsCount() != disk.size() or streaming.hull() != disk_hull) {
+            std::cerr << "Test 17.3 failed. (streaming convex hull)\n";
+            return 1;
+        }
+    }
+
+    // Simplification testing
+    {
+        std::mt19937 gen(41);
+        std::uniform_real_distribution<double> noise(-0.01, 0.01);
+        Point corners[] = {Point(0, 0), Point(10, 0), Point(10, 10), Point(0, 10)};
+        std::vector<Point> contour;
+        for (size_t side = 0; side < 4; ++side) {
+            const Point& a = corners[side];
+            const Point& b = corners[(side + 1) % 4];
+            contour.push_back(a);
+            for (size_t i = 1; i < 100; ++i) {
+                double t = i / 100.0;
+                contour.emplace_back(a.x + t * (b.x - a.x) + noise(gen), a.y + t * (b.y - a.y) + noise(gen));
+            }
+        }
+        Polygon noisy(contour);
+        Polygon square({corners[0], corners[1], corners[2], corners[3]});
+        Polygon dp = simplifyDouglasPeucker(noisy, 0.1);
+        if (dp != square) {
+            std::cerr << "Test 18.0 failed. (Douglas-Peucker)\n";
+            return 1;
+        }
+        if (simplifyDouglasPeucker(noisy, 1e-6).verticesCount() != noisy.verticesCount()) {
+            std::cerr << "Test 18.1 failed. (Douglas-Peucker keeps vertices above tolerance)\n";
+            return 1;
+        }
+        Polygon vw = simplifyVisvalingam(noisy, 1.0);
+        if (vw != square or simplifyVisvalingam(square, 1e9).verticesCount() != 3) {
+            std::cerr << "Test 18.2 failed. (Visvalingam-Whyatt)\n";
+            return 1;
+        }
+    }
+
+    // Intersection testing
+    {
+        auto crossing = Line(Point(0, 0), Point(2, 2)).intersection(Line(Point(0, 2), Point(2, 0)));
+        if (!crossing or *crossing != Point(1, 1) or Line(0.5, 1).intersection(Line(0.5, 3))) {
+            std::cerr << "Test 19.0 failed. (line intersection)\n";
+            return 1;
+        }
+        Segment s1(Point(0, 0), Point(4, 4)), s2(Point(0, 4), Point(4, 0)), s3(Point(5, 5), Point(6, 0));
+        Segment s4(Point(4, 4), Point(8, 4)), s5(Point(2, 2), Point(6, 6));
+        if (!s1.intersects(s2) or *s1.intersection(s2) != Point(2, 2) or s1.intersects(s3) or
+            *s1.intersection(s4) != Point(4, 4) or !s1.intersects(s5) or
+            *s3.intersection(Line(Point(0, 4), Point(1, 4))) != Point(5.2, 4)) {
+            std::cerr << "Test 19.1 failed. (segment intersection)\n";
+            return 1;
+        }
+
+        std::mt19937 gen(38);
+        std::uniform_int_distribution<int> coord(0, 12);  // integer grid: shared endpoints, overlaps, verticals
+        std::vector<Segment> segments;
+        for (size_t i = 0; i < 400; ++i) {
+            segments.emplace_back(Point(coord(gen), coord(gen)), Point(coord(gen), coord(gen)));
+        }
+        std::vector<std::pair<size_t, size_t>> expected;
+        for (size_t i = 0; i < segments.size(); ++i) {
+            for (size_t j = i + 1; j < segments.size(); ++j) {
+                if (segments[i].intersects(segments[j])) {
+                    expected.emplace_back(i, j);
+                }
+            }
+        }
+        auto pairs = intersectingPairs(segments);
+        if (pairs != expected) {
+            std::cerr << "Test 19.2 failed. (sweep-line intersecting pairs)\n";
+            return 1;
+        }
+
+        Polygon square({Point(0, 0), Point(4, 0), Point(4, 4), Point(0, 4)});
+        Polygon bow({Point(0, 0), Point(4, 4), Point(4, 0), Point(0, 4)});
+        Polygon inner({Point(1, 1), Point(2, 1), Point(2, 2)});
+        Polygon touching({Point(4, 4), Point(6, 4), Point(6, 6)});
+        Polygon far({Point(10, 10), Point(12, 10), Point(12, 12)});
+        if (!isSimple(square) or isSimple(bow) or !polygonsIntersect(square, inner) or
+            !polygonsIntersect(touching, square) or polygonsIntersect(square, far)) {
+            std::cerr << "Test 19.3 failed. (polygon intersection tests)\n";
+            return 1;
+        }
+
+        Polygon shifted = RegularPolygonForTest(2100, Point(3, 0));
+        if (!polygonsIntersect(RegularPolygonForTest(2100, Point(0, 0)), shifted) or
+            polygonsIntersect(RegularPolygonForTest(2100, Point(0, 0)), RegularPolygonForTest(2100, Point(4.5, 0)))) {
+            std::cerr << "Test 19.4 failed. (sweep-based polygon intersection)\n";
+            return 1;
+        }
+
+        Polygon clipped = clipPolygon(square, Polygon({Point(2, -1), Point(6, 3), Point(2, 3)}));
+        Polygon outside = clipPolygon(square, far);
+        if (!equals(clipped.area(), 5.5) or !clipped.containsPoint(Point(3, 2)) or outside.verticesCount() != 0 or
+            !equals(clipPolygon(inner, square).area(), inner.area())) {
+            std::cerr << "Test 19.5 failed. (polygon clipping)\n";
+            return 1;
+        }
+    }
+
+    // Triangulation testing
+    {
+        Polygon arrow({Point(0, 0), Point(4, 2), Point(0, 4), Point(1, 2)});  // fan from vertex 0 overlaps itself
+        if (!equals(arrow.area(), 6) or !equals(PolygonSoA(arrow).area(), 6)) {
+            std::cerr << "Test 20.0 failed. (non-convex polygon area)\n";
+            return 1;
+        }
+
+        std::vector<Point> comb = {Point(0, 0)};  // teeth up and down, horizontal and collinear edges
+        for (int i = 0; i < 50; ++i) {
+            double depth = 1 + i % 3;
+            comb.insert(comb.end(), {Point(2 * i + 1, 0), Point(2 * i + 1, -depth), Point(2 * i + 2, -depth),
+                                     Point(2 * i + 2, 0)});
+        }
+        comb.insert(comb.end(), {Point(101, 0), Point(101, 3)});
+        for (int i = 50; i > 0; --i) {
+            double height = 4 + i % 2;
+            comb.insert(comb.end(), {Point(2 * i, 3), Point(2 * i, height), Point(2 * i - 1, height),
+                                     Point(2 * i - 1, 3)});
+        }
+        comb.emplace_back(0, 3);
+        std::vector<Point> reversed(comb.rbegin(), comb.rend());
+        std::vector<Point> star;
+        for (size_t i = 0; i < 40; ++i) {
+            double radius = (i % 2) ? 1 : 3;
+            star.emplace_back(radius * cos(M_PI * i / 20), radius * sin(M_PI * i / 20));
+        }
+
+        for (const auto& vertices : {comb, reversed, star}) {
+            Polygon polygon(vertices);
+            for (const auto& indices : {earClippingIndices(polygon), monotoneIndices(polygon)}) {
+                TriangleMesh mesh(vertices, indices);
+                bool valid = (mesh.trianglesCount() == vertices.size() - 2) and equals(mesh.area(), polygon.area());
+                for (size_t t = 0; valid and (t < mesh.trianglesCount()); ++t) {
+                    Triangle triangle = mesh.triangle(t);
+                    const auto& corners = triangle.getVertices();
+                    Point center((corners[0].x + corners[1].x + corners[2].x) / 3,
+                                 (corners[0].y + corners[1].y + corners[2].y) / 3);
+                    valid = (triangle.area() > 0) and polygon.containsPoint(center) and
+                            (cross(corners[0], corners[1], corners[2]) > 0);
+                }
+                if (!valid) {
+                    std::cerr << "Test 20.1 failed. (triangulation of a simple polygon)\n";
+                    return 1;
+                }
+            }
+        }
+
+        Polygon square({Point(0, 0), Point(4, 0), Point(4, 4), Point(0, 4)});
+        TriangleMesh mesh(arrow);
+        std::vector<Triangle> triangles = triangulate(arrow);
+        if (triangles.size() != 2 or mesh.centroid() != Point(5.0 / 3, 2) or !mesh.containsPoint(Point(3, 2)) or
+            mesh.containsPoint(Point(0.5, 2)) or TriangleMesh(square).centroid() != Point(2, 2)) {
+            std::cerr << "Test 20.2 failed. (triangle mesh measurements)\n";
+            return 1;
+        }
+    }
+
+    // Rotation testing
+    {
+        std::mt19937 gen(40);
+        std::uniform_real_distribution<double> angle(-1e4, 1e4);
+        std::vector<double> angles = {0, M_PI / 2, -M_PI, 1e7, -3e9};
+        for (size_t i = 0; i < 10000; ++i) {
+            angles.push_back(angle(gen));
+        }
+        std::vector<double> sines(angles.size()), cosines(angles.size());
+        batchSinCos(angles.data(), angles.size(), sines.data(), cosines.data());
+        for (size_t i = 0; i < angles.size(); ++i) {
+            if (!equals(sines[i], sin(angles[i]), 1e-15) or !equals(cosines[i], cos(angles[i]), 1e-15)) {
+                std::cerr << "Test 21.0 failed. (batched sincos)\n";
+                return 1;
+            }
+        }
+
+        std::vector<double> degrees = {30, -135, 720};
+        std::vector<Rotation> rotations = batchRotations(degrees);
+        Polygon by_angle({Point(1, 0), Point(3, 1), Point(2, 4)});
+        Polygon by_rotation = by_angle;
+        for (size_t i = 0; i < degrees.size(); ++i) {
+            by_angle.rotate(Point(1, 2), degrees[i]);
+            by_rotation.rotate(Point(1, 2), rotations[i]);
+        }
+        Rotation combined = Rotation::degrees(30).then(Rotation::degrees(60));
+        if (by_angle != by_rotation or combined.apply(Point(2, 0)) != Point(0, 2) or
+            !equals(rotations[1].cos, -sqrt(0.5), 1e-15)) {
+            std::cerr << "Test 21.1 failed. (rotation by precomputed sincos)\n";
+            return 1;
+        }
+    }
+
+    // Robust predicates testing
+    {
+        Point q(12, 12), r(24, 24);  // points near the line y = x, one ulp of 0.5 apart
+        double ulp = std::ldexp(1.0, -53);
+        size_t naive_errors = 0;
+        for (int i = 0; i < 32; ++i) {
+            for (int j = 0; j < 32; ++j) {
+                Point p(0.5 + i * ulp, 0.5 + j * ulp);
+                int expected = (j > i) - (j < i);
+                double exact = orientation(q, r, p), naive = cross(q, r, p);
+                if ((exact > 0) - (exact < 0) != expected) {
+                    std::cerr << "Test 22.0 failed. (adaptive orientation)\n";
+                    return 1;
+                }
+                naive_errors += ((naive > 0) - (naive < 0) != expected);
+            }
+        }
+        if (naive_errors == 0) {
+            std::cerr << "Test 22.0 failed. (degenerate grid no longer exercises the exact path)\n";
+            return 1;
+        }
+
+        Point a(1, 0), b(0, 1), c(-1, 0);
+        double x = std::ldexp(1.0, -30);  // x * x stays representable: expansions are exact without underflow
+        if (inCircle(a, b, c, Point(0, -1)) != 0 or inCircle(a, b, c, Point(x, -1)) >= 0 or
+            inCircle(a, b, c, Point(0, std::nextafter(-1.0, -2.0))) >= 0 or inCircle(a, b, c, Point(0, 0)) <= 0) {
+            std::cerr << "Test 22.1 failed. (adaptive in-circle)\n";
+            return 1;
+        }
+
+        Triangle triangle(a, b, c);
+        Triangle flat(Point(0, 0), Point(1e-30, 1e-30), Point(3e15, 3e15));
+        if (triangle.isDegenerate() or !flat.isDegenerate() or triangle.inCircumscribedCircle(Point(0, -1)) != 0 or
+            Triangle(c, b, a).inCircumscribedCircle(Point(0.5, 0.5)) != 1 or triangle.inCircumscribedCircle(Point(2, 2)) != -1) {
+            std::cerr << "Test 22.2 failed. (triangle predicates)\n";
+            return 1;
+        }
+
+        Line far1(Point(1e12, 1e12), Point(1e12 + 1, 1e12 + 2)), far2(Point(1e12 + 2, 1e12 + 4), Point(1e12 + 3, 1e12 + 6));
+        Line far3(Point(1e12, 1e12 + 1e5), Point(1e12 + 1, 1e12 + 1e5 + 2));
+        Line near1(Point(0, 0), Point(1, 1e-6)), near2(Point(0, 0), Point(1, -1e-6));
+        if (far1 != far2 or far1 == far3 or near1 == near2 or Line(Point(0, 1), Point(1, 1)) != Line(0, 1) or
+            Point(1e12, 1) != Point(1e12 + 1e-4, 1)) {
+            std::cerr << "Test 22.3 failed. (scale-invariant line and point equality)\n";
+            return 1;
+        }
+
+        std::vector<Point> ccw = {Point(0, 0), Point(2, 0), Point(2, 0), Point(2, 2), Point(1, 1), Point(0, 2)};
+        std::vector<Point> cw(ccw.rbegin(), ccw.rend());
+        if (Polygon(ccw).orientation() != 1 or Polygon(cw).orientation() != -1 or
+            Polygon({Point(0, 0), Point(1, 1), Point(2, 2)}).orientation() != 0) {
+            std::cerr << "Test 22.4 failed. (polygon orientation)\n";
+            return 1;
+        }
+    }
+
+    // Point index testing
+    {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<double> coord(-50, 50);
+        std::vector<Point> points, queries;
+        for (size_t i = 0; i < 3000; ++i) {
+            points.emplace_back(std::round(coord(gen)), coord(gen));  // many equal x coordinates
+        }
+        points.push_back(points[17]);  // a duplicate
+        for (size_t i = 0; i < 300; ++i) {
+            queries.emplace_back(coord(gen) * 1.2, coord(gen) * 1.2);
+        }
+        auto brute_nearest = [&](const Point& q, size_t excluded) {
+            double best = INFINITY;
+            for (size_t i = 0; i < points.size(); ++i) {
+                if (i != excluded) {
+                    best = std::min(best, sqrDistance(q, points[i]));
+                }
+            }
+            return best;
+        };
+        auto brute_radius = [&](const Point& q, double r) {
+            std::vector<size_t> res;
+            for (size_t i = 0; i < points.size(); ++i) {
+                if (sqrDistance(q, points[i]) <= r * r) {
+                    res.push_back(i);
+                }
+            }
+            return res;
+        };
+        PointKdTree tree(points);
+        PointGrid grid(points, 2.5);
+        std::vector<size_t> tree_nearest = tree.nearest(queries), grid_nearest = grid.nearest(queries);
+        for (size_t i = 0; i < queries.size(); ++i) {
+            double expected = brute_nearest(queries[i], kNoPoint);
+            if (sqrDistance(queries[i], points[tree_nearest[i]]) != expected or
+                sqrDistance(queries[i], points[grid_nearest[i]]) != expected) {
+                std::cerr << "Test 23.1 failed. (nearest neighbor)\n";
+                return 1;
+            }
+        }
+
+        for (size_t i = 0; i < 50; ++i) {
+            std::vector<size_t> knn = tree.nearest(queries[i], 7);
+            std::vector<double> expected;
+            for (const auto& p : points) {
+                expected.push_back(sqrDistance(queries[i], p));
+            }
+            std::sort(expected.begin(), expected.end());
+            for (size_t j = 0; j < 7; ++j) {
+                if (knn.size() != 7 or sqrDistance(queries[i], points[knn[j]]) != expected[j]) {
+                    std::cerr << "Test 23.2 failed. (k nearest neighbors)\n";
+                    return 1;
+                }
+            }
+        }
+
+        auto tree_radius = tree.radiusSearch(queries, 4);
+        for (size_t i = 0; i < queries.size(); ++i) {
+            std::vector<size_t> expected = brute_radius(queries[i], 4);
+            std::vector<size_t> from_grid = grid.radiusSearch(queries[i], 4);
+            std::sort(tree_radius[i].begin(), tree_radius[i].end());
+            std::sort(from_grid.begin(), from_grid.end());
+            if (tree_radius[i] != expected or from_grid != expected) {
+                std::cerr << "Test 23.3 failed. (radius search)\n";
+                return 1;
+            }
+        }
+
+        std::vector<size_t> neighbors = tree.allNearestNeighbors();
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (neighbors[i] == i or sqrDistance(points[i], points[neighbors[i]]) != brute_nearest(points[i], i)) {
+                std::cerr << "Test 23.4 failed. (all nearest neighbors)\n";
+                return 1;
+            }
+        }
+
+        auto pair = closestPair(points);
+        if (!pair or *pair != std::make_pair(size_t(17), points.size() - 1) or closestPair(std::vector<Point>{Point(1, 1)}) or
+            PointKdTree(std::vector<Point>()).nearest(Point(0, 0)) != kNoPoint or PointGrid(std::vector<Point>(), 1).nearest(Point(0, 0)) != kNoPoint or
+            !PointGrid(std::vector<Point>(), 1).radiusSearch(Point(0, 0), 5).empty()) {
+            std::cerr << "Test 23.5 failed. (closest pair and empty indexes)\n";
+            return 1;
+        }
+    }
+
+    // Ellipse cache testing
+    {
+        Ellipse ellipse(Point(-1, 2), Point(3, 5), 9);
+        double perimeter = ellipse.perimeter(), area = ellipse.area(), eccentricity = ellipse.eccentricity();
+        ellipse.rotate(Point(4, -1), 71);
+        ellipse.reflex(Line(Point(0, 1), Point(2, 7)));
+        ellipse.scale(Point(1, 1), -2.5);
+        Ellipse fresh(ellipse.focuses().first, ellipse.focuses().second, 9 * 2.5);
+        if (!equals(ellipse.perimeter(), 2.5 * perimeter) or !equals(ellipse.perimeter(), fresh.perimeter()) or
+            !equals(ellipse.area(), 6.25 * area) or !equals(ellipse.eccentricity(), eccentricity) or
+            !equals(ellipse.boundingBox().max.x, fresh.boundingBox().max.x)) {
+            std::cerr << "Test 24.1 failed. (cached ellipse parameters after transforms)\n";
+            return 1;
+        }
+
+        Circle circle(Point(2, -3), 1.5);
+        Ellipse as_ellipse(Point(2, -3), Point(2, -3), 3);
+        circle.scale(Point(0, 0), 2);
+        as_ellipse.scale(Point(0, 0), 2);
+        if (!equals(circle.perimeter(), as_ellipse.perimeter()) or !equals(circle.area(), as_ellipse.area()) or
+            !equals(circle.area(), M_PI * 9) or circle.eccentricity() != 0 or
+            !equals(circle.boundingBox().min.y, as_ellipse.boundingBox().min.y)) {
+            std::cerr << "Test 24.2 failed. (circle fast path)\n";
+            return 1;
+        }
+    }
+
+    // Triangle centers testing
+    {
+        Triangle right(Point(0, 0), Point(4, 0), Point(0, 3));
+        TriangleCenters c = right.centers();
+        if (c.circumcenter != Point(2, 1.5) or !equals(c.circumradius, 2.5) or c.incenter != Point(1, 1) or
+            !equals(c.inradius, 1) or c.orthocenter != Point(0, 0) or c.centroid != Point(4.0 / 3, 1) or
+            c.nine_point_center != Point(1, 0.75) or !equals(c.nine_point_radius, 1.25)) {
+            std::cerr << "Test 25.1 failed. (centers of a right triangle)\n";
+            return 1;
+        }
+
+        std::mt19937 gen(8);
+        std::uniform_real_distribution<double> coord(-100, 100);
+        std::vector<Triangle> triangles;
+        for (size_t i = 0; i < 1000; ++i) {
+            triangles.emplace_back(Point(coord(gen), coord(gen)), Point(coord(gen), coord(gen)),
+                                   Point(coord(gen), coord(gen)));
+        }
+        TriangleCentersSoA batch = TrianglesSoA(triangles).centers();
+        for (size_t i = 0; i < triangles.size(); ++i) {
+            TriangleCenters one = triangles[i].centers();
+            auto close = [](double a, double b) { return std::abs(a - b) <= 1e-9 * std::max(1.0, std::abs(b)); };
+            if (!close(batch.circumcenter_x[i], one.circumcenter.x) or
+                !close(batch.circumcenter_y[i], one.circumcenter.y) or
+                !close(batch.circumradius[i], one.circumradius) or !close(batch.incenter_x[i], one.incenter.x) or
+                !close(batch.incenter_y[i], one.incenter.y) or !close(batch.inradius[i], one.inradius) or
+                !close(batch.centroid_x[i], one.centroid.x) or !close(batch.orthocenter_y[i], one.orthocenter.y) or
+                !close(batch.nine_point_x[i], one.nine_point_center.x) or
+                !close(batch.nine_point_radius[i], one.nine_point_radius) or
+                !equals(distance(one.incenter, triangles[i].inscribedCircle().center()), 0) or
+                !close(distance(one.circumcenter, triangles[i].getVertices()[2]), one.circumradius)) {
+                std::cerr << "Test 25.2 failed. (batched triangle centers)\n";
+                return 1;
+            }
+        }
+    }
+
+    // Shape serialization testing
+    {
+        ShapeStore store;
+        store.add(Polygon({Point(0, 0), Point(4, 0), Point(5, 3), Point(1, 2), Point(-1, 1)}));
+        store.add(Ellipse(Point(-1, 0.5), Point(2, 2), 7));
+        store.add(Circle(Point(3, -1), 2.5));
+        Rectangle rectangle(Point(0, 0), Point(3, 4), 2);
+        rectangle.reflex(Line(Point(0, 1), Point(1, 3)));  // the corners are no longer in constructor order
+        store.add(rectangle);
+        store.add(Square(Point(1, 1), Point(3, 3)));
+        store.add(Triangle(Point(0, 0), Point(1, 0), Point(0.1, 1e-7)));
+        std::stringstream stream;
+        ShapeWriter writer(stream);
+        writer.write(store);
+        writer.write(Polygon(std::vector<Point>(100000, Point(1e300, -1e-300))));
+        std::string bytes = stream.str();
+
+        ShapeStore from_stream, from_memory;
+        ShapeReader stream_reader(stream);
+        ShapeReader memory_reader(bytes.data(), bytes.size());
+        if (writer.failed() or stream_reader.readAll(from_stream) != 7 or memory_reader.readAll(from_memory) != 7 or
+            stream_reader.failed() or memory_reader.failed() or from_stream.get<Polygon>()[1].verticesCount() != 100000) {
+            std::cerr << "Test 26.1 failed. (shape round trip)\n";
+            return 1;
+        }
+        for (const ShapeStore* loaded : {&from_stream, &from_memory}) {
+            if (loaded->get<Polygon>()[0].getVertices() != store.get<Polygon>()[0].getVertices() or
+                !(Ellipse(loaded->get<Ellipse>()[0]) == store.get<Ellipse>()[0]) or
+                loaded->get<Circle>()[0].center() != Point(3, -1) or loaded->get<Circle>()[0].radius() != 2.5 or
+                loaded->get<Rectangle>()[0].getVertices() != rectangle.getVertices() or
+                loaded->get<Square>()[0].getVertices() != store.get<Square>()[0].getVertices() or
+                loaded->get<Triangle>()[0].getVertices()[2].y != 1e-7 or
+                loaded->get<Polygon>()[1].getVertices().back().y != -1e-300) {
+                std::cerr << "Test 26.2 failed. (loaded shapes equal the written ones)\n";
+                return 1;
+            }
+        }
+
+        ShapeStore partial;
+        ShapeReader truncated(bytes.data(), bytes.size() - 8);
+        std::string wrong_magic = "GSHQ" + bytes.substr(4);
+        ShapeReader bad_header(wrong_magic.data(), wrong_magic.size());
+        if (truncated.readAll(partial) != 6 or !truncated.failed() or bad_header.next() or !bad_header.failed()) {
+            std::cerr << "Test 26.3 failed. (malformed input)\n";
+            return 1;
+        }
+
+        const char* path = "shape_io_test.bin";
+        {
+            std::ofstream file(path, std::ios::binary);
+            file.write(bytes.data(), bytes.size());
+        }
+        ShapeStore mapped_store;
+        {
+            MappedFile mapped(path);
+            ShapeReader mapped_reader(mapped.data(), mapped.size());
+            if (!mapped.isOpen() or mapped.size() != bytes.size() or mapped_reader.readAll(mapped_store) != 7 or
+                MappedFile("no_such_file.bin").isOpen()) {
+                std::cerr << "Test 26.4 failed. (memory-mapped file)\n";
+                return 1;
+            }
+        }
+        std::remove(path);
+    }
+
+    // Scene measurement testing
+    {
+        std::mt19937 gen(21);
+        std::uniform_real_distribution<double> coord(-500, 500), size(0.5, 5);
+        ShapeStore store;
+        std::vector<std::unique_ptr<Shape>> owned;
+        for (size_t i = 0; i < 3 * kSceneBlock + 17; ++i) {
+            Point p(coord(gen), coord(gen)), q(p.x + size(gen), p.y + size(gen));
+            if (i % 3 == 0) {
+                owned.emplace_back(new Circle(p, size(gen)));
+                store.add(Circle(p, size(gen)));
+            } else if (i % 3 == 1) {
+                owned.emplace_back(new Ellipse(p, q, 3 * distance(p, q)));
+                store.add(Ellipse(p, q, 3 * distance(p, q)));
+            } else {
+                owned.emplace_back(new Triangle(p, q, Point(p.x, q.y + 1)));
+                store.add(Triangle(p, q, Point(p.x, q.y + 1)));
+            }
+        }
+        std::vector<Shape*> shapes;
+        double area = 0, perimeter = 0;
+        BoundingBox box;
+        for (const auto& shape : owned) {
+            shapes.push_back(shape.get());
+            area += shape->area();
+            perimeter += shape->perimeter();
+            box.extend(shape->boundingBox());
+        }
+        SceneMeasures measures = measureScene(shapes);
+        if (!equals(measures.area, area, 1e-6 * area) or !equals(measures.perimeter, perimeter, 1e-6 * perimeter) or
+            measures.box.min != box.min or measures.box.max != box.max or
+            !equals(measureScene(store).area, store.totalArea(), 1e-6 * area)) {
+            std::cerr << "Test 27.1 failed. (parallel scene measurements)\n";
+            return 1;
+        }
+        SceneMeasures empty = measureScene(std::vector<Shape*>());
+        if (empty.area != 0 or !empty.box.empty() or measureScene(shapes).area != measures.area) {
+            std::cerr << "Test 27.2 failed. (empty and repeated scene measurements)\n";
+            return 1;
+        }
+        Ellipse instanced(Point(-1, 0), Point(2, 1), 6);  // one shape listed in many blocks, read concurrently
+        Circle instanced_circle(Point(3, 3), 1);
+        std::vector<Shape*> instances;
+        for (size_t i = 0; i < 16 * kSceneBlock + 5; ++i) {
+            instances.push_back(i % 3 == 0 ? static_cast<Shape*>(&instanced_circle) : &instanced);
+        }
+        SceneMeasures repeated = measureScene(instances);
+        size_t circles = (instances.size() + 2) / 3, ellipses = instances.size() - circles;
+        if (!equals(repeated.area, ellipses * instanced.area() + circles * instanced_circle.area(), 1e-9 * repeated.area) or
+            !equals(repeated.perimeter, ellipses * instanced.perimeter() + circles * instanced_circle.perimeter(),
+                    1e-9 * repeated.perimeter) or
+            repeated.box.min.x != std::min(instanced.boundingBox().min.x, instanced_circle.boundingBox().min.x)) {
+            std::cerr << "Test 27.3 failed. (shape repeated across scene blocks)\n";
+            return 1;
+        }
+    }
+
+    // Compact coordinates testing
+    {
+        Polygon polygon = RegularPolygonForTest(1000, Point(37.6, 55.7), 0.05);  // about 5 km around a city center
+        CompactPolygon<float> as_float(polygon);
+        CompactPolygon<int32_t> as_fixed(polygon);
+        double step = as_fixed.getFrame().unit;
+        if (as_float.verticesCount() != 1000 or !equals(as_float.area(), polygon.area(), 1e-6 * polygon.area()) or
+            !equals(as_fixed.area(), polygon.area(), 1e-6 * polygon.area()) or
+            !equals(as_fixed.perimeter(), polygon.perimeter(), 1e-6) or step > 1e-10 or
+            !equals(as_fixed.vertex(10).x, polygon.getVertices()[10].x, step) or
+            !equals(as_float.vertex(10).y, polygon.getVertices()[10].y, 1e-8) or
+            !equals(as_fixed.boundingBox().max.x, polygon.boundingBox().max.x, step) or
+            as_fixed.toPolygon().verticesCount() != 1000 or as_float.orientation() != 1) {
+            std::cerr << "Test 28.1 failed. (float and fixed-point storage)\n";
+            return 1;
+        }
+
+        std::mt19937 gen(17);
+        std::uniform_real_distribution<double> offset(-0.06, 0.06);
+        for (size_t i = 0; i < 1000; ++i) {
+            Point p(37.6 + offset(gen), 55.7 + offset(gen));
+            double r = distance(p, Point(37.6, 55.7));
+            if ((r < 0.0499 or r > 0.0501) and
+                (as_fixed.containsPoint(p) != polygon.containsPoint(p) or
+                 as_float.containsPoint(p) != polygon.containsPoint(p))) {
+                std::cerr << "Test 28.2 failed. (compact point in polygon)\n";
+                return 1;
+            }
+        }
+
+        CoordinateFrame frame{Point(0, 0), 0.5};  // fixed point in half units
+        CompactPolygon<int32_t> square(Polygon({Point(0, 0), Point(3, 0), Point(3, 3), Point(0, 3)}), frame);
+        CompactPolygon<int32_t> clockwise(Polygon({Point(0, 0), Point(0, 3), Point(3, 3), Point(3, 0)}), frame);
+        if (!square.containsPoint(Point(1.5, 3)) or !square.containsPoint(Point(3, 0)) or
+            square.containsPoint(Point(1.5, std::nextafter(3.0, 4.0))) or square.area() != 9 or
+            clockwise.orientation() != -1 or CompactPolygon<float>(Polygon({})).area() != 0) {
+            std::cerr << "Test 28.3 failed. (exact predicates on stored coordinates)\n";
+            return 1;
+        }
+        std::vector<Point> reversed = RegularPolygonForTest(600, Point(3, -1)).getVertices();
+        std::reverse(reversed.begin(), reversed.end());
+        std::vector<Polygon> oriented = {Polygon(reversed),
+                                         Polygon({Point(0, 0), Point(0, 0), Point(2, 0), Point(1, 2)}),  // flat turn
+                                         Polygon({Point(0, 0), Point(1, 1), Point(2, 2)})};
+        for (const Polygon& shape : oriented) {
+            if ((CompactPolygon<float>(shape).orientation() != shape.orientation()) or
+                (CompactPolygon<int32_t>(shape).orientation() != shape.orientation())) {
+                std::cerr << "Test 28.4 failed. (compact orientation)\n";
+                return 1;
+            }
+        }
+    }
+
+    // Line batch operations testing
+    {
+        Line line(Point(1, 0), Point(3, 4));  // y = 2 * x - 2
+        LineCoeffs coeffs = line.coeffs();
+        std::vector<double> old_coeffs = line.getLineCoeffs();
+        std::vector<Point> points = {Point(0, 0), Point(2, 2), Point(-3, 7), Point(1e6, -1e6), Point(2, 2)};
+        std::vector<double> distances(points.size());
+        std::vector<Point> projections(points.size()), reflections = points;
+        line.signedDistance(points.data(), points.size(), distances.data());
+        line.projection(points.data(), points.size(), projections.data());
+        line.reflection(reflections.data(), reflections.size(), reflections.data());  // in place
+        if (coeffs.a != old_coeffs[0] or coeffs.b != old_coeffs[1] or coeffs.c != old_coeffs[2] or
+            !equals(std::abs(line.signedDistance(Point(0, 0))), 2 / sqrt(5)) or
+            !equals(std::abs(line.signedDistance(Point(3, 0))), 4 / sqrt(5)) or distances[1] != 0) {
+            std::cerr << "Test 29.1 failed. (line coefficients and distances)\n";
+            return 1;
+        }
+        AffineTransform mirror = AffineTransform().reflex(line);
+        for (size_t i = 0; i < points.size(); ++i) {
+            Point mid((points[i].x + reflections[i].x) / 2, (points[i].y + reflections[i].y) / 2);
+            if (projections[i] != line.projection(points[i]) or reflections[i] != line.reflection(points[i]) or
+                reflections[i] != mirror.apply(points[i]) or mid != projections[i] or
+                !equals(distances[i], line.signedDistance(points[i]), 1e-9 * std::max(1.0, std::abs(distances[i]))) or
+                !equals(line.signedDistance(projections[i]), 0, 1e-9 * std::max(1.0, std::abs(distances[i])))) {
+                std::cerr << "Test 29.2 failed. (batched projections and reflections)\n";
+                return 1;
+            }
+        }
+    }
+
+    // Polygon arena testing
+    {
+        std::vector<Polygon> polygons = {Polygon({Point(0, 0), Point(4, 0), Point(4, 3)}),
+                                         RegularPolygonForTest(7, Point(-5, 2)),
+                                         Rectangle(Point(1, 1), Point(5, 4), 2), Polygon({})};
+        PolygonArena arena;
+        arena.reserve(polygons.size() + 1, 64);
+        for (const auto& polygon : polygons) {
+            arena.add(polygon.getVertices());
+        }
+        size_t last = arena.add({Point(0, 0), Point(2, 0), Point(2, 2), Point(0, 2)});
+        if ((arena.size() != 5) or (last != 4) or (arena.verticesCount() != 3 + 7 + 4 + 0 + 4) or
+            !arena[3].empty() or !equals(polygonArea(arena[last]), 4) or !equals(polygonPerimeter(arena[last]), 8) or
+            !polygonContainsPoint(arena[last], Point(1, 1)) or polygonContainsPoint(arena[last], Point(3, 1))) {
+            std::cerr << "Test 30.1 failed. (arena layout)\n";
+            return 1;
+        }
+        for (size_t i = 0; i < polygons.size(); ++i) {
+            BoundingBox box = polygonBoundingBox(arena[i]), expected = polygons[i].boundingBox();
+            Polygon copy = arena.toPolygon(i);
+            if ((arena[i].size() != polygons[i].verticesCount()) or
+                !std::equal(arena[i].begin(), arena[i].end(), polygons[i].getVertices().begin()) or
+                !(copy == polygons[i]) or (polygonArea(arena[i]) != polygons[i].area()) or
+                (polygonPerimeter(arena[i]) != polygons[i].perimeter()) or (box.empty() != expected.empty()) or
+                (!box.empty() and ((box.min != expected.min) or (box.max != expected.max))) or
+                (polygonContainsPoint(arena[i], Point(2, 1)) != polygons[i].containsPoint(Point(2, 1)))) {
+                std::cerr << "Test 30.2 failed. (arena polygon " << i << ")\n";
+                return 1;
+            }
+        }
+        Rectangle rectangle(Point(1, 1), Point(5, 4), 2);
+        const Rectangle& view = rectangle;  // center() and diagonals() are const and copy-free
+        if ((view.center() != Point(3, 2.5)) or !view.diagonals().first.intersection(view.diagonals().second)) {
+            std::cerr << "Test 30.3 failed. (const rectangle queries)\n";
+            return 1;
+        }
+        arena.clear();
+        if ((arena.size() != 0) or (arena.verticesCount() != 0) or (arena.add({Point(1, 1)}) != 0)) {
+            std::cerr << "Test 30.4 failed. (arena clear)\n";
+            return 1;
+        }
+        PolygonArena copies;
+        copies.add(RegularPolygonForTest(5, Point(1, 1)).getVertices());
+        for (size_t i = 0; i < 6; ++i) {  // copies of its own polygons, through several reallocations
+            copies.add(copies[i]);
+        }
+        for (size_t i = 0; i < copies.size(); ++i) {
+            if (!std::equal(copies[i].begin(), copies[i].end(), copies[0].begin(), copies[0].end())) {
+                std::cerr << "Test 30.5 failed. (arena polygon added from the arena)\n";
+                return 1;
+            }
+        }
+    }
+
     return 0;
 }
@@ -0,0 +1,6 @@
+#!/bin/bash
+
+set -e
+
+g++ -std=c++17 -O3 -march=native -I./ bench/bench.cpp -o vector_ops_bench -lbenchmark -lpthread
+./vector_ops_bench "$@"
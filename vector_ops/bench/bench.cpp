@@ -0,0 +1,225 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+#include <fstream>
+#include "src/vector_ops.h"
+
+
+using namespace task;
+
+
+std::vector<double> RandomVector(size_t size, unsigned seed) {
+    std::mt19937 rand(seed);
+    std::uniform_real_distribution<double> dist{-10., 10.};
+    std::vector<double> vec(size);
+    for (auto& item : vec) {
+        item = dist(rand);
+    }
+    return vec;
+}
+
+std::vector<double> Scaled(const std::vector<double>& vec, double mult) {
+    std::vector<double> res(vec.size());
+    for (size_t i = 0; i < vec.size(); ++i) {
+        res[i] = vec[i] * mult;
+    }
+    return res;
+}
+
+bool DivisionCollinear(const std::vector<double>& vec1, const std::vector<double>& vec2) {  // baseline
+    for (size_t i = 1; i < vec1.size(); ++i) {
+        double delta = vec2[i] / vec1[i] - vec2[i - 1] / vec1[i - 1];
+        if (std::fabs(delta) >= kEpsilon) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+static void BM_CollinearDivision(benchmark::State& state) {
+    auto vec = RandomVector(state.range(0), 1);
+    auto vec2 = Scaled(vec, -2.5);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(DivisionCollinear(vec, vec2));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CollinearDivision)->RangeMultiplier(10)->Range(1000, 1000000);
+
+static void BM_CollinearCrossRatio(benchmark::State& state) {
+    auto vec = RandomVector(state.range(0), 1);
+    auto vec2 = Scaled(vec, -2.5);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(vec || vec2);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CollinearCrossRatio)->RangeMultiplier(10)->Range(1000, 1000000);
+
+static void BM_CodirectionalCrossRatio(benchmark::State& state) {
+    auto vec = RandomVector(state.range(0), 1);
+    auto vec2 = Scaled(vec, 2.5);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(vec && vec2);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CodirectionalCrossRatio)->RangeMultiplier(10)->Range(1000, 1000000);
+
+static void BM_CollinearEarlyExit(benchmark::State& state) {
+    auto vec = RandomVector(state.range(0), 1);
+    auto vec2 = RandomVector(state.range(0), 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(vec || vec2);
+    }
+}
+BENCHMARK(BM_CollinearEarlyExit)->RangeMultiplier(10)->Range(1000, 1000000);
+
+
+static void BM_ReverseStd(benchmark::State& state) {
+    auto vec = RandomVector(state.range(0), 1);
+    for (auto _ : state) {
+        std::reverse(vec.begin(), vec.end());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(double));
+}
+BENCHMARK(BM_ReverseStd)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+static void BM_Reverse(benchmark::State& state) {
+    auto vec = RandomVector(state.range(0), 1);
+    for (auto _ : state) {
+        reverse(vec);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(double));
+}
+BENCHMARK(BM_Reverse)->RangeMultiplier(16)->Range(1 << 12, 1 << 24)->UseRealTime();
+
+static void BM_RotateLeft(benchmark::State& state) {
+    auto vec = RandomVector(state.range(0), 1);
+    for (auto _ : state) {
+        rotate_left(vec, vec.size() / 3);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(double));
+}
+BENCHMARK(BM_RotateLeft)->RangeMultiplier(16)->Range(1 << 12, 1 << 24)->UseRealTime();
+
+static void BM_Gather(benchmark::State& state) {
+    auto vec = RandomVector(state.range(0), 1);
+    std::vector<size_t> perm(vec.size());
+    std::iota(perm.begin(), perm.end(), 0);
+    std::shuffle(perm.begin(), perm.end(), std::mt19937(3));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(gather(vec, perm));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(double));
+}
+BENCHMARK(BM_Gather)->RangeMultiplier(16)->Range(1 << 12, 1 << 24)->UseRealTime();
+
+
+static void BM_WriteStreamEndl(benchmark::State& state) {  // old operator<< behaviour
+    auto vec = RandomVector(state.range(0), 1);
+    std::ofstream out("/dev/null");
+    for (auto _ : state) {
+        for (double item : vec) {
+            out << item << " ";
+        }
+        out << std::endl;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_WriteStreamEndl)->Arg(3)->Arg(100);
+
+static void BM_WriteStream(benchmark::State& state) {
+    auto vec = RandomVector(state.range(0), 1);
+    std::ofstream out("/dev/null");
+    for (auto _ : state) {
+        out << vec;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_WriteStream)->Arg(3)->Arg(100);
+
+static void BM_WriteTextBuffered(benchmark::State& state) {
+    auto vec = RandomVector(state.range(0), 1);
+    std::ofstream out("/dev/null");
+    TextVectorWriter writer(out);
+    for (auto _ : state) {
+        writer.write(vec);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_WriteTextBuffered)->Arg(3)->Arg(100);
+
+static void BM_WriteBinary(benchmark::State& state) {
+    auto vec = RandomVector(state.range(0), 1);
+    std::ofstream out("/dev/null", std::ios::binary);
+    for (auto _ : state) {
+        write_binary(out, vec);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_WriteBinary)->Arg(3)->Arg(100);
+
+
+static void BM_Small3Dynamic(benchmark::State& state) {
+    auto vec = RandomVector(3, 1);
+    auto vec2 = RandomVector(3, 2);
+    for (auto _ : state) {
+        auto cross = (vec + vec2) % (vec - vec2);
+        benchmark::DoNotOptimize(cross * vec);
+    }
+}
+BENCHMARK(BM_Small3Dynamic);
+
+static void BM_Small3Fixed(benchmark::State& state) {
+    auto vec = to_fixed<3>(RandomVector(3, 1));
+    auto vec2 = to_fixed<3>(RandomVector(3, 2));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(vec);
+        auto cross = (vec + vec2) % (vec - vec2);
+        benchmark::DoNotOptimize(cross * vec);
+    }
+}
+BENCHMARK(BM_Small3Fixed);
+
+
+static void BM_DotSerial(benchmark::State& state) {
+    auto vec = RandomVector(state.range(0), 1);
+    auto vec2 = RandomVector(state.range(0), 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(vec * vec2);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 2 * sizeof(double));
+}
+BENCHMARK(BM_DotSerial)->RangeMultiplier(16)->Range(1 << 16, 1 << 26);
+
+static void BM_DotParallel(benchmark::State& state) {
+    auto vec = RandomVector(state.range(0), 1);
+    auto vec2 = RandomVector(state.range(0), 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dot(par, vec, vec2));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 2 * sizeof(double));
+}
+BENCHMARK(BM_DotParallel)->RangeMultiplier(16)->Range(1 << 16, 1 << 26)->UseRealTime();
+
+static void BM_PlusParallel(benchmark::State& state) {
+    auto vec = RandomVector(state.range(0), 1);
+    auto vec2 = RandomVector(state.range(0), 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(plus(par, vec, vec2));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 3 * sizeof(double));
+}
+BENCHMARK(BM_PlusParallel)->RangeMultiplier(16)->Range(1 << 16, 1 << 26)->UseRealTime();
+
+
+BENCHMARK_MAIN();
@@ -0,0 +1,104 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <cstddef>
+
+
+namespace task {
+
+    struct TolerancePolicy {  // |x| <= absolute + relative * scale counts as zero
+        double absolute;
+        double relative;
+
+        constexpr TolerancePolicy(double absolute = 1e-9, double relative = 1e-9)
+            : absolute(absolute), relative(relative) {}
+
+        bool is_zero(double x, double scale = 0.0) const {
+            return std::fabs(x) <= absolute + relative * scale;
+        }
+    };
+
+    namespace detail {
+
+        const size_t kCollinearBlock = 64;  // elements checked between early exits
+
+        // largest component of the first block that is not zero, so the pivot is well scaled
+        // without a full pass over the vector; returns size for a zero vector
+        size_t find_pivot(const double* vec, size_t size, const TolerancePolicy& policy) {
+            for (size_t begin = 0; begin < size; begin += kCollinearBlock) {
+                size_t end = begin + kCollinearBlock < size ? begin + kCollinearBlock : size;
+                size_t pivot = begin;
+                for (size_t i = begin + 1; i < end; ++i) {
+                    if (std::fabs(vec[i]) > std::fabs(vec[pivot])) {
+                        pivot = i;
+                    }
+                }
+                if (!policy.is_zero(vec[pivot])) {
+                    return pivot;
+                }
+            }
+            return size;
+        }
+
+        // checks vec1[pivot] * vec2[i] == vec1[i] * vec2[pivot] for every i, division-free
+        bool cross_ratios_vanish(const double* vec1, const double* vec2, size_t size,
+                                 size_t pivot, const TolerancePolicy& policy) {
+            const double p1 = vec1[pivot];
+            const double p2 = vec2[pivot];
+            const double absolute = policy.absolute;
+            const double relative = policy.relative;
+            for (size_t begin = 0; begin < size; begin += kCollinearBlock) {
+                size_t end = begin + kCollinearBlock < size ? begin + kCollinearBlock : size;
+                int bad = 0;
+                for (size_t i = begin; i < end; ++i) {  // branch-free body, vectorizes
+                    double lhs = p1 * vec2[i];
+                    double rhs = vec1[i] * p2;
+                    double scale = std::fabs(lhs) + std::fabs(rhs);
+                    bad |= std::fabs(lhs - rhs) > absolute + relative * scale;
+                }
+                if (bad) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    }  // namespace detail
+
+    bool is_zero(const std::vector<double>& vec, const TolerancePolicy& policy) {
+        for (size_t i = 0; i < vec.size(); ++i) {
+            if (!policy.is_zero(vec[i])) {
+                return false;
+            }
+        }
+        return true;  // zero-vector check
+    }
+
+    bool is_collinear(const std::vector<double>& vec1, const std::vector<double>& vec2,
+                      const TolerancePolicy& policy = TolerancePolicy()) {
+        if (vec1.size() != vec2.size()) {
+            return false;
+        }
+        size_t pivot = detail::find_pivot(vec1.data(), vec1.size(), policy);
+        if (pivot == vec1.size() or policy.is_zero(vec2[pivot])) {
+            return pivot == vec1.size() or is_zero(vec2, policy);  // zero vector is collinear to any vector
+        }
+        return detail::cross_ratios_vanish(vec1.data(), vec2.data(), vec1.size(), pivot, policy);
+    }
+
+    bool is_codirectional(const std::vector<double>& vec1, const std::vector<double>& vec2,
+                          const TolerancePolicy& policy = TolerancePolicy()) {
+        if (vec1.size() != vec2.size()) {
+            return false;
+        }
+        size_t pivot = detail::find_pivot(vec1.data(), vec1.size(), policy);
+        if (pivot == vec1.size() or policy.is_zero(vec2[pivot])) {
+            return pivot == vec1.size() or is_zero(vec2, policy);
+        }
+        if (vec1[pivot] * vec2[pivot] < 0) {  // collinear vectors share sign at the pivot
+            return false;
+        }
+        return detail::cross_ratios_vanish(vec1.data(), vec2.data(), vec1.size(), pivot, policy);
+    }
+
+}  // namespace task
@@ -0,0 +1,198 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+
+namespace task {
+
+    template <size_t N, class T = double>
+    struct Vec {  // fixed-size vector on the stack, aggregate: Vec<3>{{1., 2., 3.}}
+        std::array<T, N> values;
+
+        constexpr T& operator[](size_t i) { return values[i]; }
+        constexpr const T& operator[](size_t i) const { return values[i]; }
+        static constexpr size_t size() { return N; }
+        constexpr T* begin() { return values.data(); }
+        constexpr T* end() { return values.data() + N; }
+        constexpr const T* begin() const { return values.data(); }
+        constexpr const T* end() const { return values.data() + N; }
+    };
+
+    namespace detail {
+
+        template <class T>
+        constexpr T constexpr_abs(T x) {
+            return x < T(0) ? -x : x;
+        }
+
+        template <size_t N, class T, size_t... I>
+        constexpr Vec<N, T> add(const Vec<N, T>& vec1, const Vec<N, T>& vec2, std::index_sequence<I...>) {
+            return {{(vec1[I] + vec2[I])...}};
+        }
+
+        template <size_t N, class T, size_t... I>
+        constexpr Vec<N, T> sub(const Vec<N, T>& vec1, const Vec<N, T>& vec2, std::index_sequence<I...>) {
+            return {{(vec1[I] - vec2[I])...}};
+        }
+
+        template <size_t N, class T, size_t... I>
+        constexpr Vec<N, T> neg(const Vec<N, T>& vec, std::index_sequence<I...>) {
+            return {{(-vec[I])...}};
+        }
+
+        template <size_t N, class T, size_t... I>
+        constexpr T dot(const Vec<N, T>& vec1, const Vec<N, T>& vec2, std::index_sequence<I...>) {
+            return (T(0) + ... + (vec1[I] * vec2[I]));  // left fold, same summation order as the loop
+        }
+
+        template <size_t N, class T, size_t... I>
+        constexpr Vec<N, T> from_data(const T* data, std::index_sequence<I...>) {
+            return {{data[I]...}};
+        }
+
+        template <size_t N, class T>
+        constexpr size_t fixed_pivot(const Vec<N, T>& vec) {
+            size_t pivot = 0;
+            for (size_t i = 1; i < N; ++i) {
+                if (constexpr_abs(vec[i]) > constexpr_abs(vec[pivot])) {
+                    pivot = i;
+                }
+            }
+            return pivot;
+        }
+
+        template <size_t N, class T>
+        constexpr bool fixed_is_zero(const Vec<N, T>& vec, T eps) {
+            for (size_t i = 0; i < N; ++i) {
+                if (constexpr_abs(vec[i]) > eps) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // the same cross-ratio test as is_collinear, with absolute and relative tolerance eps
+        template <size_t N, class T>
+        constexpr int fixed_direction(const Vec<N, T>& vec1, const Vec<N, T>& vec2, T eps) {
+            if (N == 0 or fixed_is_zero(vec1, eps) or fixed_is_zero(vec2, eps)) {
+                return 1;  // zero vector: collinear and codirectional
+            }
+            size_t pivot = fixed_pivot(vec1);
+            T p1 = vec1[pivot];
+            T p2 = vec2[pivot];
+            for (size_t i = 0; i < N; ++i) {
+                T lhs = p1 * vec2[i];
+                T rhs = vec1[i] * p2;
+                if (constexpr_abs(lhs - rhs) > eps + eps * (constexpr_abs(lhs) + constexpr_abs(rhs))) {
+                    return 0;  // not collinear
+                }
+            }
+            return p1 * p2 < T(0) ? -1 : 1;
+        }
+
+        constexpr double kFixedEpsilon = 1e-9;  // kEpsilon, usable in constant expressions
+
+    }  // namespace detail
+
+    template <size_t N, class T>
+    constexpr Vec<N, T> operator+(const Vec<N, T>& vec1, const Vec<N, T>& vec2) {
+        return detail::add(vec1, vec2, std::make_index_sequence<N>());
+    }
+
+    template <size_t N, class T>
+    constexpr Vec<N, T> operator-(const Vec<N, T>& vec1, const Vec<N, T>& vec2) {
+        return detail::sub(vec1, vec2, std::make_index_sequence<N>());
+    }
+
+    template <size_t N, class T>
+    constexpr Vec<N, T> operator+(const Vec<N, T>& vec) {
+        return vec;
+    }
+
+    template <size_t N, class T>
+    constexpr Vec<N, T> operator-(const Vec<N, T>& vec) {
+        return detail::neg(vec, std::make_index_sequence<N>());
+    }
+
+    template <size_t N, class T>
+    constexpr T operator*(const Vec<N, T>& vec1, const Vec<N, T>& vec2) {
+        return detail::dot(vec1, vec2, std::make_index_sequence<N>());  // dot product
+    }
+
+    template <class T>
+    constexpr Vec<3, T> operator%(const Vec<3, T>& vec1, const Vec<3, T>& vec2) {
+        return {{
+            vec1[1] * vec2[2] - vec1[2] * vec2[1],
+            vec1[2] * vec2[0] - vec1[0] * vec2[2],
+            vec1[0] * vec2[1] - vec1[1] * vec2[0]
+        }};  // 3d cross product
+    }
+
+    template <size_t N, class T>
+    constexpr bool is_zero(const Vec<N, T>& vec) {
+        return detail::fixed_is_zero(vec, T(detail::kFixedEpsilon));
+    }
+
+    template <size_t N, class T>
+    constexpr bool operator||(const Vec<N, T>& vec1, const Vec<N, T>& vec2) {
+        return detail::fixed_direction(vec1, vec2, T(detail::kFixedEpsilon)) != 0;  // collinearity check
+    }
+
+    template <size_t N, class T>
+    constexpr bool operator&&(const Vec<N, T>& vec1, const Vec<N, T>& vec2) {
+        return detail::fixed_direction(vec1, vec2, T(detail::kFixedEpsilon)) == 1;  // codirectionality check
+    }
+
+
+    // conversions; mixed Vec/std::vector calls copy the first N values onto the stack
+    // and run the fixed-size path, vec.size() must be at least N
+
+    template <size_t N, class T>
+    Vec<N, T> to_fixed(const std::vector<T>& vec) {
+        return detail::from_data<N, T>(vec.data(), std::make_index_sequence<N>());
+    }
+
+    template <size_t N, class T>
+    std::vector<T> to_vector(const Vec<N, T>& vec) {
+        return std::vector<T>(vec.begin(), vec.end());
+    }
+
+    template <size_t N, class T>
+    Vec<N, T> operator+(const Vec<N, T>& vec1, const std::vector<T>& vec2) { return vec1 + to_fixed<N>(vec2); }
+
+    template <size_t N, class T>
+    Vec<N, T> operator+(const std::vector<T>& vec1, const Vec<N, T>& vec2) { return to_fixed<N>(vec1) + vec2; }
+
+    template <size_t N, class T>
+    Vec<N, T> operator-(const Vec<N, T>& vec1, const std::vector<T>& vec2) { return vec1 - to_fixed<N>(vec2); }
+
+    template <size_t N, class T>
+    Vec<N, T> operator-(const std::vector<T>& vec1, const Vec<N, T>& vec2) { return to_fixed<N>(vec1) - vec2; }
+
+    template <size_t N, class T>
+    T operator*(const Vec<N, T>& vec1, const std::vector<T>& vec2) { return vec1 * to_fixed<N>(vec2); }
+
+    template <size_t N, class T>
+    T operator*(const std::vector<T>& vec1, const Vec<N, T>& vec2) { return to_fixed<N>(vec1) * vec2; }
+
+    template <class T>
+    Vec<3, T> operator%(const Vec<3, T>& vec1, const std::vector<T>& vec2) { return vec1 % to_fixed<3>(vec2); }
+
+    template <class T>
+    Vec<3, T> operator%(const std::vector<T>& vec1, const Vec<3, T>& vec2) { return to_fixed<3>(vec1) % vec2; }
+
+    template <size_t N, class T>
+    bool operator||(const Vec<N, T>& vec1, const std::vector<T>& vec2) { return vec1 || to_fixed<N>(vec2); }
+
+    template <size_t N, class T>
+    bool operator||(const std::vector<T>& vec1, const Vec<N, T>& vec2) { return to_fixed<N>(vec1) || vec2; }
+
+    template <size_t N, class T>
+    bool operator&&(const Vec<N, T>& vec1, const std::vector<T>& vec2) { return vec1 && to_fixed<N>(vec2); }
+
+    template <size_t N, class T>
+    bool operator&&(const std::vector<T>& vec1, const Vec<N, T>& vec2) { return to_fixed<N>(vec1) && vec2; }
+
+}  // namespace task
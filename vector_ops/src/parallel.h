@@ -0,0 +1,203 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <condition_variable>
+#include <cstddef>
+
+
+namespace task {
+
+    struct parallel_policy {};  // tag selecting the multithreaded overloads
+
+    constexpr parallel_policy par{};
+
+    namespace detail {
+
+        const size_t kMinParallelChunk = 1 << 16;  // smaller ranges are not worth a thread
+        const size_t kReductionChunk = 1 << 14;  // fixed, so reductions do not depend on thread count
+
+        class ThreadPool {  // process-wide workers; tasks of a job are claimed one by one from a shared counter
+        public:
+            static ThreadPool& instance() {
+                static ThreadPool pool;
+                return pool;
+            }
+
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+
+            ~ThreadPool() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stop_ = true;
+                }
+                wake_.notify_all();
+                for (auto& worker : workers_) {
+                    worker.join();
+                }
+            }
+
+            size_t size() const {
+                return workers_.size() + 1;  // the calling thread works too
+            }
+
+            // runs task(i) for every i in [0, count) and returns when all of them are done
+            void run(size_t count, const std::function<void(size_t)>& task) {
+                if (count == 0) {
+                    return;
+                }
+                if (count == 1 or workers_.empty() or inside_pool()) {  // nested calls run inline
+                    for (size_t i = 0; i < count; ++i) {
+                        task(i);
+                    }
+                    return;
+                }
+                std::lock_guard<std::mutex> job_lock(job_mutex_);  // one job at a time
+                auto job = std::make_shared<Job>(task, count);
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    job_ = job;
+                    ++generation_;
+                }
+                wake_.notify_all();
+                {
+                    InsidePool inside;  // tasks run here may call run() again, while job_mutex_ is held
+                    work(*job);
+                }
+                std::unique_lock<std::mutex> lock(mutex_);
+                done_.wait(lock, [&] { return job->pending == 0; });
+                job_.reset();
+            }
+
+        private:
+            struct Job {  // a late worker holding a finished job finds no tasks left in it
+                Job(const std::function<void(size_t)>& task, size_t count)
+                    : task(task), count(count), pending(count) {}
+
+                const std::function<void(size_t)>& task;
+                const size_t count;
+                std::atomic<size_t> next{0};
+                std::atomic<size_t> pending;
+            };
+
+            ThreadPool() {
+                size_t hw = std::thread::hardware_concurrency();
+                for (size_t i = 1; i < hw; ++i) {
+                    workers_.emplace_back([this] { loop(); });
+                }
+            }
+
+            static bool& inside_pool() {
+                thread_local bool inside = false;
+                return inside;
+            }
+
+            class InsidePool {  // marks the calling thread as a pool thread for its scope
+            public:
+                InsidePool() : saved_(inside_pool()) {
+                    inside_pool() = true;
+                }
+
+                ~InsidePool() {
+                    inside_pool() = saved_;
+                }
+
+            private:
+                bool saved_;
+            };
+
+            void loop() {
+                inside_pool() = true;
+                size_t seen = 0;
+                while (true) {
+                    std::shared_ptr<Job> job;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        wake_.wait(lock, [&] { return stop_ or generation_ != seen; });
+                        if (stop_) {
+                            return;
+                        }
+                        seen = generation_;
+                        job = job_;
+                    }
+                    if (job) {
+                        work(*job);
+                    }
+                }
+            }
+
+            void work(Job& job) {
+                size_t finished = 0;
+                for (size_t i = job.next++; i < job.count; i = job.next++) {
+                    job.task(i);
+                    ++finished;
+                }
+                if (finished > 0 and job.pending.fetch_sub(finished) == finished) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    done_.notify_all();
+                }
+            }
+
+            std::vector<std::thread> workers_;
+            std::mutex job_mutex_;
+            std::mutex mutex_;
+            std::condition_variable wake_;
+            std::condition_variable done_;
+            std::shared_ptr<Job> job_;
+            size_t generation_ = 0;
+            bool stop_ = false;
+        };
+
+        size_t thread_count(size_t size, size_t min_chunk = kMinParallelChunk) {
+            size_t hw = ThreadPool::instance().size();
+            size_t by_size = size / min_chunk;
+            size_t count = hw < by_size ? hw : by_size;
+            return count > 0 ? count : 1;
+        }
+
+        // splits [0, size) into contiguous chunks and runs func(begin, end) on each in the pool
+        template <class Func>
+        void parallel_for(size_t size, Func func, size_t min_chunk = kMinParallelChunk) {
+            size_t count = thread_count(size, min_chunk);
+            if (count == 1) {
+                func(size_t(0), size);
+                return;
+            }
+            size_t chunk = size / count;
+            ThreadPool::instance().run(count, [&](size_t t) {
+                func(t * chunk, t + 1 == count ? size : (t + 1) * chunk);
+            });
+        }
+
+        // reduces [0, size) in fixed kReductionChunk pieces claimed dynamically by the pool,
+        // partial results are combined in chunk order, so the result is the same for any thread count
+        template <class T, class Map, class Combine>
+        T parallel_reduce(size_t size, T init, Map map, Combine combine) {
+            size_t chunks = (size + kReductionChunk - 1) / kReductionChunk;
+            std::vector<T> partial(chunks, init);
+            auto task = [&](size_t t) {
+                size_t begin = t * kReductionChunk;
+                size_t end = begin + kReductionChunk < size ? begin + kReductionChunk : size;
+                partial[t] = map(begin, end);
+            };
+            if (size < kMinParallelChunk) {
+                for (size_t t = 0; t < chunks; ++t) {
+                    task(t);
+                }
+            } else {
+                ThreadPool::instance().run(chunks, task);
+            }
+            T res = init;
+            for (size_t t = 0; t < chunks; ++t) {
+                res = combine(res, partial[t]);
+            }
+            return res;
+        }
+
+    }  // namespace detail
+
+}  // namespace task
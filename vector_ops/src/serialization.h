@@ -0,0 +1,184 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <iostream>
+#include <charconv>
+#include <exception>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+namespace task {
+
+    class SerializationException : public std::exception {};
+
+    // binary frame: uint64_t element count followed by the raw doubles, native byte order
+
+    std::ostream& write_binary(std::ostream& ostream, const std::vector<double>& vec) {
+        uint64_t size = vec.size();
+        ostream.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        ostream.write(reinterpret_cast<const char*>(vec.data()), size * sizeof(double));
+        return ostream;
+    }
+
+    const size_t kReadChunk = 1 << 16;  // doubles allocated at once, so a corrupt count cannot exhaust memory
+
+    // one frame; on a truncated frame sets failbit and leaves vec unchanged
+    std::istream& read_binary(std::istream& istream, std::vector<double>& vec) {
+        uint64_t size;
+        if (!istream.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+            return istream;
+        }
+        std::vector<double> res;
+        for (uint64_t done = 0; done < size;) {
+            size_t chunk = std::min<uint64_t>(size - done, kReadChunk);
+            res.resize(done + chunk);
+            if (!istream.read(reinterpret_cast<char*>(res.data() + done), chunk * sizeof(double))) {
+                return istream;
+            }
+            done += chunk;
+        }
+        vec.swap(res);
+        return istream;
+    }
+
+
+    class VectorView {  // non-owning read-only view of one frame
+    public:
+        VectorView(const double* data, size_t size) : data_(data), size_(size) {}
+
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        const double* data() const { return data_; }
+        const double* begin() const { return data_; }
+        const double* end() const { return data_ + size_; }
+        const double& operator[](size_t i) const { return data_[i]; }
+
+        std::vector<double> to_vector() const {
+            return std::vector<double>(begin(), end());
+        }
+
+    private:
+        const double* data_;
+        size_t size_;
+    };
+
+
+    class MappedVectorFile {  // mmap-ed file of binary frames, views point straight into the mapping
+    public:
+        explicit MappedVectorFile(const std::string& path) {
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw SerializationException();
+            }
+            struct stat info;
+            if (fstat(fd, &info) != 0) {
+                close(fd);
+                throw SerializationException();
+            }
+            length_ = info.st_size;
+            if (length_ > 0) {
+                void* addr = mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (addr == MAP_FAILED) {
+                    close(fd);
+                    throw SerializationException();
+                }
+                base_ = static_cast<const char*>(addr);
+            }
+            close(fd);
+            index();
+        }
+
+        MappedVectorFile(const MappedVectorFile&) = delete;
+        MappedVectorFile& operator=(const MappedVectorFile&) = delete;
+
+        ~MappedVectorFile() {
+            if (base_ != nullptr) {
+                munmap(const_cast<char*>(base_), length_);
+            }
+        }
+
+        size_t size() const { return views_.size(); }
+        const VectorView& operator[](size_t i) const { return views_[i]; }
+        std::vector<VectorView>::const_iterator begin() const { return views_.begin(); }
+        std::vector<VectorView>::const_iterator end() const { return views_.end(); }
+
+    private:
+        void index() {  // walks frame headers only, payload is never touched
+            size_t offset = 0;
+            while (offset < length_) {
+                uint64_t size;
+                if (length_ - offset < sizeof(size)) {
+                    throw SerializationException();
+                }
+                std::memcpy(&size, base_ + offset, sizeof(size));
+                offset += sizeof(size);
+                if ((length_ - offset) / sizeof(double) < size) {
+                    throw SerializationException();  // truncated frame
+                }
+                views_.emplace_back(reinterpret_cast<const double*>(base_ + offset), size);
+                offset += size * sizeof(double);
+            }
+        }
+
+        const char* base_ = nullptr;
+        size_t length_ = 0;
+        std::vector<VectorView> views_;
+    };
+
+
+    // Same layout as operator<<, formatted into a buffer and written in blocks. Values are printed with std::to_chars
+    // at shortest round-trip precision (0.1234567), not at the stream precision operator<< uses (0.123457).
+    class TextVectorWriter {
+    public:
+        explicit TextVectorWriter(std::ostream& ostream, size_t capacity = 1 << 16)
+            : ostream_(ostream), capacity_(capacity) {
+            buffer_.reserve(capacity_ + kMaxValueLength);
+        }
+
+        TextVectorWriter(const TextVectorWriter&) = delete;
+        TextVectorWriter& operator=(const TextVectorWriter&) = delete;
+
+        ~TextVectorWriter() {
+            flush();
+        }
+
+        TextVectorWriter& write(const std::vector<double>& vec) {
+            char chars[kMaxValueLength];
+            for (size_t i = 0; i < vec.size(); ++i) {
+                char* last = std::to_chars(chars, chars + kMaxValueLength, vec[i]).ptr;
+                buffer_.append(chars, last);
+                buffer_.push_back(' ');
+                if (buffer_.size() >= capacity_) {
+                    drain();
+                }
+            }
+            buffer_.push_back('\n');
+            return *this;
+        }
+
+        void flush() {  // the only place the underlying stream is flushed
+            drain();
+            ostream_.flush();
+        }
+
+    private:
+        static const size_t kMaxValueLength = 32;  // shortest round-trip double fits in 24 chars
+
+        void drain() {
+            ostream_.write(buffer_.data(), buffer_.size());
+            buffer_.clear();
+        }
+
+        std::ostream& ostream_;
+        size_t capacity_;
+        std::string buffer_;
+    };
+
+}  // namespace task
@@ -0,0 +1,110 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <cstddef>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "parallel.h"
+
+
+namespace task {
+
+    namespace detail {
+
+        // swaps data[i] and data[size - 1 - i] for i in [begin, end), end <= size / 2
+        template <class T>
+        void swap_mirrored(T* data, size_t size, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                std::swap(data[i], data[size - 1 - i]);
+            }
+        }
+
+#if defined(__AVX2__) || defined(__SSE2__)
+        void swap_mirrored(double* data, size_t size, size_t begin, size_t end) {
+            size_t i = begin;
+#ifdef __AVX2__
+            for (; i + 4 <= end; i += 4) {  // four lanes from each side, reversed by a permute
+                double* lo = data + i;
+                double* hi = data + size - 4 - i;
+                __m256d front = _mm256_loadu_pd(lo);
+                __m256d back = _mm256_loadu_pd(hi);
+                _mm256_storeu_pd(lo, _mm256_permute4x64_pd(back, 0x1b));
+                _mm256_storeu_pd(hi, _mm256_permute4x64_pd(front, 0x1b));
+            }
+#endif
+            for (; i + 2 <= end; i += 2) {  // two lanes from each side, swapped by a shuffle
+                double* lo = data + i;
+                double* hi = data + size - 2 - i;
+                __m128d front = _mm_loadu_pd(lo);
+                __m128d back = _mm_loadu_pd(hi);
+                _mm_storeu_pd(lo, _mm_shuffle_pd(back, back, 1));
+                _mm_storeu_pd(hi, _mm_shuffle_pd(front, front, 1));
+            }
+            for (; i < end; ++i) {
+                std::swap(data[i], data[size - 1 - i]);
+            }
+        }
+#endif
+
+    }  // namespace detail
+
+    template <class T>
+    void reverse_range(T* data, size_t size) {  // chunked over threads for large ranges
+        detail::parallel_for(size / 2, [data, size](size_t begin, size_t end) {
+            detail::swap_mirrored(data, size, begin, end);
+        });
+    }
+
+    template <class T>
+    void rotate_left(std::vector<T>& vec, size_t shift) {  // three reversals, each parallel
+        if (vec.empty()) {
+            return;
+        }
+        shift %= vec.size();
+        if (shift == 0) {
+            return;
+        }
+        reverse_range(vec.data(), shift);
+        reverse_range(vec.data() + shift, vec.size() - shift);
+        reverse_range(vec.data(), vec.size());
+    }
+
+    template <class T>
+    void rotate_right(std::vector<T>& vec, size_t shift) {
+        if (vec.empty()) {
+            return;
+        }
+        rotate_left(vec, vec.size() - shift % vec.size());
+    }
+
+    template <class T>
+    std::vector<T> gather(const std::vector<T>& vec, const std::vector<size_t>& perm) {  // res[i] = vec[perm[i]]
+        std::vector<T> res(perm.size());
+        detail::parallel_for(perm.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                res[i] = vec[perm[i]];
+            }
+        });
+        return res;
+    }
+
+    template <class T>
+    std::vector<T> scatter(const std::vector<T>& vec, const std::vector<size_t>& perm) {  // res[perm[i]] = vec[i]
+        std::vector<T> res(vec.size());
+        detail::parallel_for(vec.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                res[perm[i]] = vec[i];
+            }
+        });
+        return res;
+    }
+
+    template <class T>
+    void apply_permutation(std::vector<T>& vec, const std::vector<size_t>& perm) {  // vec[i] = old vec[perm[i]]
+        vec = gather(vec, perm);
+    }
+
+}  // namespace task
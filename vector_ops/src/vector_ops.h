@@ -2,6 +2,11 @@
 #include <vector>
 #include <iostream>
 #include <cmath>
+#include "parallel.h"
+#include "collinearity.h"
+#include "transform.h"
+#include "serialization.h"
+#include "fixed_vector.h"
 
 
 namespace task {
@@ -16,6 +21,16 @@ namespace task {
         return vec3;
     }
 
+    std::vector<double> plus(const parallel_policy&, const std::vector<double>& vec1, const std::vector<double>& vec2) {
+        std::vector<double> vec3(vec1.size());
+        detail::parallel_for(vec1.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                vec3[i] = vec1[i] + vec2[i];
+            }
+        });
+        return vec3;
+    }
+
     std::vector<double> operator-(const std::vector<double>& vec1, const std::vector<double>& vec2) {
         std::vector<double> vec3(vec1.size());
         for (size_t i = 0; i < vec1.size(); ++i) {
@@ -44,6 +59,16 @@ namespace task {
         return dp;  // dot product
     }
 
+    double dot(const parallel_policy&, const std::vector<double>& vec1, const std::vector<double>& vec2) {
+        return detail::parallel_reduce(vec1.size(), 0.0, [&](size_t begin, size_t end) {
+            double dp = 0.0;
+            for (size_t i = begin; i < end; ++i) {
+                dp += vec1[i] * vec2[i];
+            }
+            return dp;
+        }, [](double lhs, double rhs) { return lhs + rhs; });  // same result for any thread count
+    }
+
     std::vector<double> operator%(const std::vector<double>& vec1, const std::vector<double>& vec2) {
         std::vector<double> vec3 = {
             vec1[1] * vec2[2] - vec1[2] * vec2[1],
@@ -54,30 +79,26 @@ namespace task {
     }
 
     bool is_zero(const std::vector<double>& vec) {
-        for (size_t i = 0; i < vec.size(); ++i) {
-            if (vec[i] >= kEpsilon) {
-                return false;
+        return is_zero(vec, TolerancePolicy(kEpsilon, 0.0));  // zero-vector check
+    }
+
+    bool is_zero(const parallel_policy&, const std::vector<double>& vec) {
+        TolerancePolicy policy(kEpsilon, 0.0);
+        return detail::parallel_reduce(vec.size(), 1, [&](size_t begin, size_t end) {
+            int zero = 1;  // int, not bool: partial results must not share bytes between threads
+            for (size_t i = begin; i < end; ++i) {
+                zero &= policy.is_zero(vec[i]);
             }
-        }
-        return true;  // zero-vector check
+            return zero;
+        }, [](int lhs, int rhs) { return lhs & rhs; }) != 0;
     }
 
     bool operator||(const std::vector<double>& vec1, const std::vector<double>& vec2) {
-        if (!is_zero(vec1) and !is_zero(vec2)) {  // for non-zero vectors
-            for (size_t i = 1; i < vec1.size(); ++i) {
-                double delta = vec2[i] / vec1[i] - vec2[i - 1] / vec1[i - 1];
-                if (abs(delta) >= kEpsilon) {
-                    return false;
-                }
-            }
-            return true;
-        } else {
-            return true;
-        }  // collinearity check
+        return is_collinear(vec1, vec2, TolerancePolicy(kEpsilon, kEpsilon));  // collinearity check
     }
 
     bool operator&&(const std::vector<double>& vec1, const std::vector<double>& vec2) {
-        return (vec1 || vec2) and (vec1 * vec2 >= 0);  // codirectionality check
+        return is_codirectional(vec1, vec2, TolerancePolicy(kEpsilon, kEpsilon));  // codirectionality check
     }
 
     std::istream& operator>>(std::istream& istream, std::vector<double>& vec) {
@@ -94,15 +115,12 @@ namespace task {
         for (size_t i = 0; i < vec.size(); ++i) {
             ostream << vec[i] << " ";
         }
-        ostream << std::endl;
+        ostream << '\n';  // no flush per vector, see TextVectorWriter for bulk output
         return ostream;
     }
 
     void reverse(std::vector<double>& vec) {
-        for (size_t i = 0; i < vec.size() / 2; ++i) {
-            size_t j = vec.size() - 1 - i;
-            std::swap(vec[i], vec[j]);
-        }
+        reverse_range(vec.data(), vec.size());
     }
 
     std::vector<int> operator|(const std::vector<int>& vec1, const std::vector<int>& vec2) {
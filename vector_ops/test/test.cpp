@@ -5,7 +5,9 @@
 #include <vector>
 #include <valarray>
 #include <sstream>
+#include <fstream>
 #include <cmath>
+#include <cstdio>
 #include "src/vector_ops.h"
 
 
@@ -202,6 +204,30 @@ int main() {
         ASSERT_TRUE_MSG(!(vec && vec2), "Codirectionality operator")
     }
 
+    REPEAT(100)
+    {
+        std::vector<double> vec, vec2;
+        RandomFillDouble(vec, 1000);
+
+        auto mult = RandomDouble();
+        size_t zero_index = RandomUInt(vec.size() - 1);
+        vec[zero_index] = 0.;
+
+        for (auto& item : vec) {
+            vec2.push_back(item * mult);
+        }
+
+        ASSERT_TRUE_MSG(vec || vec2, "Collinearity operator with zero components")
+        ASSERT_TRUE_MSG((vec && vec2) == (mult > 0), "Codirectionality operator with zero components")
+
+        vec2[zero_index] = 1.;
+        ASSERT_TRUE_MSG(!(vec || vec2), "Collinearity operator with zero components")
+
+        std::vector<double> negative(vec.size(), -1.);
+        ASSERT_TRUE_MSG(!is_zero(negative), "Zero-vector check")
+        ASSERT_TRUE_MSG(is_collinear(vec, vec, TolerancePolicy(0., 0.)), "Collinearity with exact policy")
+    }
+
     REPEAT(100)
     {
         std::vector<double> vec, vec2;
@@ -235,4 +261,177 @@ int main() {
         ASSERT_EQUAL_MSG(vec, vec2, "reverse")
     }
 
+    REPEAT(10)
+    {
+        std::vector<double> vec, vec2;
+        RandomFillDouble(vec, RandomUInt(1, 300000));
+
+        vec2 = vec;
+        reverse(vec);
+        std::reverse(vec2.begin(), vec2.end());
+        ASSERT_EQUAL_MSG(vec, vec2, "reverse on large vector")
+
+        size_t shift = RandomUInt(2 * vec.size());
+        rotate_left(vec, shift);
+        std::rotate(vec2.begin(), vec2.begin() + shift % vec2.size(), vec2.end());
+        ASSERT_EQUAL_MSG(vec, vec2, "rotate_left")
+
+        rotate_right(vec, shift);
+        std::rotate(vec2.rbegin(), vec2.rbegin() + shift % vec2.size(), vec2.rend());
+        ASSERT_EQUAL_MSG(vec, vec2, "rotate_right")
+
+        std::vector<size_t> perm(vec.size());
+        for (size_t i = 0; i < perm.size(); ++i) {
+            perm[i] = i;
+        }
+        std::shuffle(perm.begin(), perm.end(), std::mt19937(RandomUInt()));
+
+        auto gathered = gather(vec, perm);
+        ASSERT_TRUE_MSG(gathered[0] == vec[perm[0]] && gathered.back() == vec[perm.back()], "gather")
+        auto scattered = scatter(gathered, perm);
+        ASSERT_EQUAL_MSG(scattered, vec, "scatter")
+
+        apply_permutation(vec2, perm);
+        ASSERT_EQUAL_MSG(vec2, gathered, "apply_permutation")
+    }
+
+    {
+        std::vector<std::vector<double>> vecs(10);
+        for (auto& vec : vecs) {
+            RandomFillDouble(vec, RandomUInt(1000));
+        }
+
+        std::stringstream stream;
+        for (const auto& vec : vecs) {
+            write_binary(stream, vec);
+        }
+        std::vector<double> vec;
+        for (const auto& expected : vecs) {
+            ASSERT_TRUE_MSG(read_binary(stream, vec), "Binary read")
+            ASSERT_EQUAL_MSG(vec, expected, "Binary round trip")
+        }
+        ASSERT_TRUE_MSG(!read_binary(stream, vec), "Binary read past the end")
+
+        const char* path = "vector_ops_test.bin";
+        {
+            std::ofstream file(path, std::ios::binary);
+            for (const auto& expected : vecs) {
+                write_binary(file, expected);
+            }
+        }
+        {
+            MappedVectorFile mapped(path);
+            ASSERT_TRUE_MSG(mapped.size() == vecs.size(), "Mapped frame count")
+            for (size_t i = 0; i < vecs.size(); ++i) {
+                ASSERT_EQUAL_MSG(mapped[i], vecs[i], "Mapped vector view")
+            }
+        }
+        std::remove(path);
+
+        std::stringstream text;
+        {
+            TextVectorWriter writer(text, 64);
+            for (const auto& expected : vecs) {
+                writer.write(expected);
+            }
+        }
+        for (const auto& expected : vecs) {
+            std::stringstream line;
+            line << expected.size() << '\n';
+            std::string values;
+            std::getline(text, values);
+            line << values;
+            line >> vec;
+            ASSERT_EQUAL_MSG(vec, expected, "Buffered text writer round trip")
+        }
+
+        std::stringstream shortest, streamed;
+        {
+            TextVectorWriter writer(shortest);
+            writer.write({0.1234567, 2.5});
+        }
+        streamed << std::vector<double>{0.1234567, 2.5};
+        ASSERT_TRUE_MSG(shortest.str() == "0.1234567 2.5 \n", "Text writer prints round-trip precision")
+        ASSERT_TRUE_MSG(streamed.str() == "0.123457 2.5 \n", "operator<< prints stream precision")
+
+        std::stringstream frame;
+        write_binary(frame, vecs[0]);
+        write_binary(frame, std::vector<double>{1, 2, 3});
+        std::string bytes = frame.str();
+        std::stringstream truncated(bytes.substr(0, bytes.size() - sizeof(double)));
+        ASSERT_TRUE_MSG(read_binary(truncated, vec) && vec == vecs[0], "Binary read before a truncated frame")
+        ASSERT_TRUE_MSG(!read_binary(truncated, vec) && vec == vecs[0], "Truncated frame leaves the vector unchanged")
+        uint64_t huge = uint64_t(1) << 60;
+        std::stringstream corrupt(std::string(reinterpret_cast<const char*>(&huge), sizeof(huge)) + "12345678");
+        ASSERT_TRUE_MSG(!read_binary(corrupt, vec) && vec == vecs[0], "Corrupt frame count")
+    }
+
+    {
+        constexpr Vec<3> a{{1., 2., 3.}}, b{{-2., 0., 1.}};
+        static_assert((a + b)[0] == -1. && (a - b)[2] == 2. && (-a)[1] == -2., "Fixed-size + and -");
+        static_assert(a * b == 1., "Fixed-size dot product");
+        static_assert((a % b)[0] == 2. && (a % b)[1] == -7. && (a % b)[2] == 4., "Fixed-size cross product");
+        static_assert((a || (a + a)) && (a && (a + a)) && !(a && -a) && !(a || b), "Fixed-size collinearity");
+    }
+
+    REPEAT(100)
+    {
+        std::vector<double> vec, vec2;
+        RandomFillDouble(vec, 3);
+        RandomFillDouble(vec2, 3);
+        auto fixed = to_fixed<3>(vec);
+        auto fixed2 = to_fixed<3>(vec2);
+
+        auto sum = vec + vec2;
+        auto fixed_sum = fixed + fixed2;
+        ASSERT_EQUAL_MSG(fixed_sum, sum, "Fixed-size binary +")
+        auto diff = vec - vec2;
+        auto mixed_diff = fixed - vec2;
+        ASSERT_EQUAL_MSG(mixed_diff, diff, "Mixed binary -")
+        auto cross = vec % vec2;
+        auto mixed_cross = vec % fixed2;
+        ASSERT_EQUAL_MSG(mixed_cross, cross, "Mixed cross product")
+        ASSERT_TRUE_MSG(fixed * fixed2 == vec * vec2, "Fixed-size dot product")
+
+        auto mult = RandomDouble();
+        auto scaled = to_fixed<3>(std::vector<double>{vec[0] * mult, vec[1] * mult, vec[2] * mult});
+        ASSERT_TRUE_MSG(fixed || scaled, "Fixed-size collinearity operator")
+        ASSERT_TRUE_MSG((fixed && scaled) == (mult > 0), "Fixed-size codirectionality operator")
+        ASSERT_TRUE_MSG((fixed || fixed2) == (vec || vec2), "Fixed-size collinearity operator")
+    }
+
+    REPEAT(5)
+    {
+        std::vector<double> vec, vec2;
+        RandomFillDouble(vec, RandomUInt(100000, 1000000));
+        RandomFillDouble(vec2, vec.size());
+
+        auto sum = plus(par, vec, vec2);
+        auto expected_sum = vec + vec2;
+        ASSERT_EQUAL_MSG(sum, expected_sum, "Parallel binary +")
+
+        double dp = dot(par, vec, vec2);
+        ASSERT_TRUE_MSG(fabs(dp - vec * vec2) < EPS * vec.size(), "Parallel dot product")
+        ASSERT_TRUE_MSG(dp == dot(par, vec, vec2), "Parallel dot product is deterministic")
+
+        ASSERT_TRUE_MSG(!is_zero(par, vec), "Parallel zero-vector check")
+        ASSERT_TRUE_MSG(is_zero(par, std::vector<double>(vec.size(), 0.)), "Parallel zero-vector check")
+    }
+
+    {
+        std::vector<double> vec;
+        RandomFillDouble(vec, 4 * detail::kMinParallelChunk);
+        size_t chunks = 64;
+        auto nested = detail::parallel_reduce(chunks * detail::kReductionChunk, size_t(0), [&](size_t, size_t) {
+            std::vector<double> doubled(vec.size());  // every task calls into the pool again
+            detail::parallel_for(vec.size(), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    doubled[i] = vec[i] + vec[i];
+                }
+            });
+            return size_t(doubled == vec + vec);
+        }, [](size_t a, size_t b) { return a + b; });
+        ASSERT_TRUE_MSG(nested == chunks, "Nested parallel calls")
+    }
+
 }